@@ -14,6 +14,12 @@
 
 namespace llvm {
 
+    /*
+     * Topology of the machine.
+     *
+     * It is discovered from /sys/devices/system/cpu the first time it is needed.
+     * Only the logical cores the current process is allowed to run on (e.g., because of cpusets) are considered.
+     */
     class Architecture {
       public:
         Architecture ();
@@ -22,9 +28,55 @@ namespace llvm {
 
         static uint32_t getNumberOfPhysicalCores (void);
 
+        static uint32_t getNumberOfSockets (void);
+
+        static uint32_t getNumberOfNUMANodes (void);
+
+        /*
+         * Return the number of logical cores that share a physical core (i.e., SMT ways).
+         */
+        static uint32_t getNumberOfLogicalCoresPerPhysicalCore (void);
+
+        /*
+         * Return the logical cores that share the physical core of @logicalCore (including @logicalCore).
+         */
+        static std::vector<uint32_t> getLogicalCoresOfTheSamePhysicalCore (uint32_t logicalCore);
+
+        /*
+         * Return the logical cores in the order threads should be placed on them:
+         * one logical core per physical core first, and then their SMT siblings.
+         */
+        static std::vector<uint32_t> getLogicalCoresInPlacementOrder (void);
+
         static int32_t getCacheLineBytes (void);
 
+        static uint64_t getL1DataCacheBytes (void);
+
+        static uint64_t getL2CacheBytes (void);
+
+        static uint64_t getLastLevelCacheBytes (void);
+
       private:
+        class Topology {
+          public:
+            Topology ();
+
+            std::vector<uint32_t> logicalCores;
+            std::vector<std::vector<uint32_t>> physicalCores;
+            std::unordered_map<uint32_t, uint32_t> physicalCoreOfLogicalCore;
+            uint32_t sockets;
+            uint32_t NUMANodes;
+            int32_t cacheLineBytes;
+            uint64_t L1DataCacheBytes;
+            uint64_t L2CacheBytes;
+            uint64_t lastLevelCacheBytes;
+
+          private:
+            void discoverCores (void);
+            void discoverCaches (uint32_t logicalCore);
+        };
+
+        static const Topology & getTopology (void);
   };
 
 }
@@ -10,20 +10,265 @@
  */
 #include "Architecture.hpp"
 
+#include <fstream>
+#include <sched.h>
+#include <dirent.h>
+
 using namespace llvm;
 
+static const std::string sysCPUDirectory = "/sys/devices/system/cpu/";
+
+static bool readSysFile (const std::string &fileName, std::string &content){
+  std::ifstream file(fileName);
+  if (!file.is_open()){
+    return false;
+  }
+  std::getline(file, content);
+
+  return !file.fail();
+}
+
+static bool readSysFile (const std::string &fileName, uint64_t &value){
+  std::string content;
+  if (!readSysFile(fileName, content)){
+    return false;
+  }
+
+  /*
+   * Parse the number and its optional unit (e.g., "32K" for cache sizes).
+   */
+  char *unit = nullptr;
+  value = strtoull(content.c_str(), &unit, 10);
+  if (unit == content.c_str()){
+    return false;
+  }
+  switch (*unit){
+    case 'K':
+      value *= 1024;
+      break ;
+    case 'M':
+      value *= 1024 * 1024;
+      break ;
+    case 'G':
+      value *= 1024 * 1024 * 1024;
+      break ;
+  }
+
+  return true;
+}
+
 Architecture::Architecture (){
   return ;
 }
-    
+
+Architecture::Topology::Topology ()
+  : sockets{1}
+  , NUMANodes{1}
+  , cacheLineBytes{64}
+  , L1DataCacheBytes{32 * 1024}
+  , L2CacheBytes{256 * 1024}
+  , lastLevelCacheBytes{8 * 1024 * 1024}
+  {
+
+  /*
+   * Discover logical, physical cores, sockets, and NUMA nodes.
+   */
+  this->discoverCores();
+
+  /*
+   * Discover the caches.
+   */
+  this->discoverCaches(this->logicalCores[0]);
+
+  return ;
+}
+
+void Architecture::Topology::discoverCores (void){
+
+  /*
+   * Fetch the logical cores the process is allowed to run on.
+   */
+  cpu_set_t allowedCores;
+  CPU_ZERO(&allowedCores);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowedCores) == 0){
+    for (uint32_t core = 0; core < CPU_SETSIZE; core++){
+      if (CPU_ISSET(core, &allowedCores)){
+        this->logicalCores.push_back(core);
+      }
+    }
+  }
+  if (this->logicalCores.size() == 0){
+    auto cores = std::max(std::thread::hardware_concurrency(), 1U);
+    for (uint32_t core = 0; core < cores; core++){
+      this->logicalCores.push_back(core);
+    }
+  }
+
+  /*
+   * Group logical cores by physical core, and count sockets and NUMA nodes.
+   */
+  std::map<std::pair<uint64_t, uint64_t>, uint32_t> physicalCoreIDs;
+  std::set<uint64_t> socketIDs;
+  std::set<uint64_t> NUMANodeIDs;
+  for (auto logicalCore : this->logicalCores){
+    auto coreDirectory = sysCPUDirectory + "cpu" + std::to_string(logicalCore) + "/";
+
+    /*
+     * Fetch the socket and the physical core.
+     * If the topology is not available, then every logical core is considered a physical core.
+     */
+    uint64_t socketID = 0;
+    uint64_t coreID = logicalCore;
+    if (  (!readSysFile(coreDirectory + "topology/physical_package_id", socketID))
+          || (!readSysFile(coreDirectory + "topology/core_id", coreID))  ){
+      socketID = 0;
+      coreID = logicalCore;
+    }
+    socketIDs.insert(socketID);
+
+    /*
+     * Assign the logical core to its physical core.
+     */
+    auto key = std::make_pair(socketID, coreID);
+    if (physicalCoreIDs.find(key) == physicalCoreIDs.end()){
+      physicalCoreIDs[key] = this->physicalCores.size();
+      this->physicalCores.push_back({});
+    }
+    auto physicalCoreIndex = physicalCoreIDs[key];
+    this->physicalCores[physicalCoreIndex].push_back(logicalCore);
+    this->physicalCoreOfLogicalCore[logicalCore] = physicalCoreIndex;
+
+    /*
+     * Fetch the NUMA node (i.e., the "nodeN" entry of the directory of the logical core).
+     */
+    if (auto directory = opendir(coreDirectory.c_str())){
+      while (auto entry = readdir(directory)){
+        std::string entryName{entry->d_name};
+        if (  (entryName.size() > 4)
+              && (entryName.compare(0, 4, "node") == 0)
+              && (isdigit(entryName[4]))  ){
+          NUMANodeIDs.insert(std::stoull(entryName.substr(4)));
+        }
+      }
+      closedir(directory);
+    }
+  }
+  this->sockets = std::max<uint32_t>(socketIDs.size(), 1);
+  this->NUMANodes = std::max<uint32_t>(NUMANodeIDs.size(), 1);
+
+  return ;
+}
+
+void Architecture::Topology::discoverCaches (uint32_t logicalCore){
+
+  /*
+   * Consider all caches of the logical core.
+   */
+  uint32_t lastLevel = 0;
+  for (uint32_t index = 0; ; index++){
+    auto cacheDirectory = sysCPUDirectory + "cpu" + std::to_string(logicalCore) + "/cache/index" + std::to_string(index) + "/";
+
+    /*
+     * Fetch the attributes of the cache.
+     */
+    uint64_t level, size;
+    std::string type;
+    if (  (!readSysFile(cacheDirectory + "level", level))
+          || (!readSysFile(cacheDirectory + "size", size))
+          || (!readSysFile(cacheDirectory + "type", type))  ){
+      break ;
+    }
+    if (type == "Instruction"){
+      continue ;
+    }
+
+    /*
+     * Record the cache.
+     */
+    if (level == 1){
+      this->L1DataCacheBytes = size;
+      uint64_t lineSize;
+      if (readSysFile(cacheDirectory + "coherency_line_size", lineSize)){
+        this->cacheLineBytes = lineSize;
+      }
+    } else if (level == 2){
+      this->L2CacheBytes = size;
+    }
+    if (level >= lastLevel){
+      lastLevel = level;
+      this->lastLevelCacheBytes = size;
+    }
+  }
+
+  return ;
+}
+
+const Architecture::Topology & Architecture::getTopology (void){
+  static Topology topology;
+
+  return topology;
+}
+
 uint32_t Architecture::getNumberOfLogicalCores (void){
-  return std::thread::hardware_concurrency();
+  return getTopology().logicalCores.size();
 }
 
 uint32_t Architecture::getNumberOfPhysicalCores (void){
-  return getNumberOfLogicalCores() / 2;
+  return getTopology().physicalCores.size();
+}
+
+uint32_t Architecture::getNumberOfSockets (void){
+  return getTopology().sockets;
+}
+
+uint32_t Architecture::getNumberOfNUMANodes (void){
+  return getTopology().NUMANodes;
+}
+
+uint32_t Architecture::getNumberOfLogicalCoresPerPhysicalCore (void){
+  return getNumberOfLogicalCores() / getNumberOfPhysicalCores();
+}
+
+std::vector<uint32_t> Architecture::getLogicalCoresOfTheSamePhysicalCore (uint32_t logicalCore){
+  auto &topology = getTopology();
+  if (topology.physicalCoreOfLogicalCore.find(logicalCore) == topology.physicalCoreOfLogicalCore.end()){
+    return {};
+  }
+  auto physicalCore = topology.physicalCoreOfLogicalCore.at(logicalCore);
+
+  return topology.physicalCores[physicalCore];
+}
+
+std::vector<uint32_t> Architecture::getLogicalCoresInPlacementOrder (void){
+  auto &topology = getTopology();
+  std::vector<uint32_t> cores;
+
+  /*
+   * Take the i-th logical core of every physical core before the (i+1)-th one.
+   */
+  for (uint32_t sibling = 0; cores.size() < topology.logicalCores.size(); sibling++){
+    for (auto &physicalCore : topology.physicalCores){
+      if (sibling < physicalCore.size()){
+        cores.push_back(physicalCore[sibling]);
+      }
+    }
+  }
+
+  return cores;
 }
 
 int32_t Architecture::getCacheLineBytes (void){
-  return 64;
+  return getTopology().cacheLineBytes;
+}
+
+uint64_t Architecture::getL1DataCacheBytes (void){
+  return getTopology().L1DataCacheBytes;
+}
+
+uint64_t Architecture::getL2CacheBytes (void){
+  return getTopology().L2CacheBytes;
+}
+
+uint64_t Architecture::getLastLevelCacheBytes (void){
+  return getTopology().lastLevelCacheBytes;
 }
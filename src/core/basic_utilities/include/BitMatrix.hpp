@@ -9,11 +9,13 @@ namespace llvm {
 // BitMatrix is a NxN bit-matrix that depicts whether a relation R
 // holds for a pair with indices (i,j) (i.e., R(i,j) = 0/1)
 // BitMatrix is intended for a dense, asymmetric relation R.
+// Each row is stored as a sequence of 64-bit words, so row-level operations
+// process 64 columns at a time.
 struct BitMatrix {
-  BitMatrix(uint32_t n = 1) : N(n), bv(n * n) {}
+  BitMatrix(uint32_t n = 1) : N(n), wordsPerRow(numberOfWords(n)), words(((size_t)n) * numberOfWords(n), 0) {}
 
-  // Returns the size of BitVector
-  uint32_t count() const;
+  // Returns the number of pairs (i,j) that are set
+  uint64_t count() const;
 
   // Specifies that row is related to col, i.e., R(row,col) = 1
   void set(uint32_t row, uint32_t col, bool v = true);
@@ -27,15 +29,32 @@ struct BitMatrix {
 
   // Computes the transitive closure.
   // For example, given a adjacency matrix, it converts it to a connectivity
-  // matrix, where (i,j) is set if there is a directed path from i to j
+  // matrix, where (i,j) is set if there is a directed path from i to j.
+  // Rows are merged in reverse topological order of the relation, so the
+  // closure of a DAG with e pairs costs O(n*e/64).
   void transitiveClosure();
 
+  // Returns the number of columns set in row
+  uint32_t countRow(uint32_t row) const;
+
+  // Sets in dstRow every column set in srcRow,
+  // i.e., R(dstRow,*) |= R(srcRow,*)
+  void unionRows(uint32_t dstRow, uint32_t srcRow);
+
+  // Resets in dstRow every column that is not set in srcRow,
+  // i.e., R(dstRow,*) &= R(srcRow,*)
+  void intersectRows(uint32_t dstRow, uint32_t srcRow);
+
+  // Returns the number of columns set in both row1 and row2
+  uint32_t countRowsIntersection(uint32_t row1, uint32_t row2) const;
+
   // Emits to fout the BitMatrix
   void dump(raw_ostream &fout) const;
 
 private:
   uint32_t N;
-  BitVector bv;
+  uint32_t wordsPerRow;
+  std::vector<uint64_t> words;
 
   // For a given row returns the first col that is set.
   // Returns -1 if none found.
@@ -45,9 +64,16 @@ private:
   // Returns -1 if none found.
   int32_t nextSuccessor(uint32_t row, uint32_t prev) const;
 
-  // Returns the index corresponding to a pair (row.col)
-  // i.e., idx = row * N + col
-  uint32_t idx(uint32_t row, uint32_t col) const;
+  // For a given row returns the first col starting from col (included) that is set.
+  // Returns -1 if none found.
+  int32_t findSuccessorFrom(uint32_t row, uint32_t col) const;
+
+  // Returns the first word of a row
+  uint64_t *rowWords(uint32_t row);
+  const uint64_t *rowWords(uint32_t row) const;
+
+  // Returns the number of words needed to store n bits
+  static uint32_t numberOfWords(uint32_t n);
 };
 
 } // namespace llvm
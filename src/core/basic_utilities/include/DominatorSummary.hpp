@@ -40,8 +40,27 @@ namespace llvm {
     DomNodeSummary *parent;
     std::vector<DomNodeSummary *> children;
     DomNodeSummary *iDom;
+
+    /*
+     * Entry and exit numbers of the node in a depth-first visit of the summarized tree.
+     * A node dominates another one if and only if the interval of the former encloses the interval of the latter.
+     */
+    uint32_t dfsEntry;
+    uint32_t dfsExit;
+
+    /*
+     * The i-th element is the 2^i-th ancestor of the node in the summarized tree.
+     */
+    std::vector<DomNodeSummary *> ancestors;
   };
 
+  /*
+   * Snapshot of a (post-)dominator tree.
+   *
+   * The order of the instructions within each basic block is captured when the summary is computed (or transferred to clones).
+   * Instructions added afterwards are handled, but the summary must be recomputed after instructions of a basic block are reordered (e.g., moveBefore, moveAfter) or erased:
+   * otherwise dominates(Instruction *, Instruction *) can answer using stale positions, including the one of an erased instruction whose memory is reused by a new instruction.
+   */
   class DomTreeSummary {
    public:
     DomTreeSummary (DominatorTree &DT);
@@ -64,6 +83,8 @@ namespace llvm {
     );
     template <typename NodeType>
     void cloneNodes (std::set<NodeType *> &nodes);
+    void numberNodes (void);
+    void collectInstructionPositions (void);
 
    public:
     DomNodeSummary *getNode (BasicBlock *B) const ;
@@ -77,6 +98,12 @@ namespace llvm {
    private:
     std::set<DomNodeSummary *> nodes;
     std::unordered_map<BasicBlock *, DomNodeSummary *> bbNodeMap;
+
+    /*
+     * Position of each instruction within its basic block when the summary was computed.
+     * These positions are not updated when the IR changes (see the comment of the class).
+     */
+    std::unordered_map<Instruction *, std::pair<BasicBlock *, uint32_t>> instructionPositions;
   };
 
   class DominatorSummary {
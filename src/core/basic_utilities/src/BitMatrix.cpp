@@ -2,112 +2,204 @@
 
 namespace llvm {
 
+uint32_t BitMatrix::numberOfWords(uint32_t n) { return (n + 63) / 64; }
+
 void BitMatrix::resize(uint32_t n) {
   N = n;
-  bv.clear();
-  bv.resize(n * n);
+  wordsPerRow = numberOfWords(n);
+  words.assign(((size_t)n) * wordsPerRow, 0);
 }
 
-uint32_t BitMatrix::idx(uint32_t row, uint32_t col) const {
+uint64_t *BitMatrix::rowWords(uint32_t row) {
   assert(row < N);
-  assert(col < N);
-  return row * N + col;
+  return words.data() + ((size_t)row) * wordsPerRow;
+}
+
+const uint64_t *BitMatrix::rowWords(uint32_t row) const {
+  assert(row < N);
+  return words.data() + ((size_t)row) * wordsPerRow;
 }
 
-uint32_t BitMatrix::count() const { return bv.count(); }
+uint64_t BitMatrix::count() const {
+  uint64_t c = 0;
+  for (auto word : words) {
+    c += countPopulation(word);
+  }
+
+  return c;
+}
 
 void BitMatrix::set(uint32_t row, uint32_t col, bool v) {
-  const uint32_t i = idx(row, col);
+  assert(col < N);
+  const uint64_t mask = ((uint64_t)1) << (col % 64);
+  auto &word = rowWords(row)[col / 64];
 
   if (v) {
-    bv.set(i);
+    word |= mask;
   } else {
-    bv.reset(i);
+    word &= ~mask;
   }
 }
 
 bool BitMatrix::test(uint32_t row, uint32_t col) const {
-  const uint32_t i = idx(row, col);
+  assert(col < N);
+  const uint64_t mask = ((uint64_t)1) << (col % 64);
 
-  return bv.test(i);
+  return (rowWords(row)[col / 64] & mask) != 0;
 }
 
-int32_t BitMatrix::firstSuccessor(uint32_t row) const {
-  const uint32_t rowBegin = N * row;
-  int32_t next = -1;
-
-  if (0 == rowBegin) {
-    next = bv.find_first();
-  } else {
-    next = bv.find_next(rowBegin - 1);
-  }
-
-  if (-1 == next) {
+int32_t BitMatrix::findSuccessorFrom(uint32_t row, uint32_t col) const {
+  if (col >= N) {
     return -1;
   }
 
-  const uint32_t rowEnd = rowBegin + N;
-  if (((uint32_t)next) >= rowEnd) {
-    return -1;
+  // Skip the columns before col within its word
+  auto rowBegin = rowWords(row);
+  uint32_t w = col / 64;
+  uint64_t word = rowBegin[w] & (~((uint64_t)0) << (col % 64));
+
+  while (word == 0) {
+    ++w;
+    if (w == wordsPerRow) {
+      return -1;
+    }
+    word = rowBegin[w];
   }
 
-  return next - rowBegin;
+  return w * 64 + countTrailingZeros(word);
+}
+
+int32_t BitMatrix::firstSuccessor(uint32_t row) const {
+  return findSuccessorFrom(row, 0);
 }
 
 int32_t BitMatrix::nextSuccessor(uint32_t row, uint32_t prev) const {
-  int32_t next = bv.find_next(N * row + prev);
-  if (-1 == next) {
-    return -1;
-  }
+  return findSuccessorFrom(row, prev + 1);
+}
 
-  const uint32_t rowBegin = N * row;
-  const uint32_t rowEnd = rowBegin + N;
-  if (((uint32_t)next) >= rowEnd) {
-    return -1;
+uint32_t BitMatrix::countRow(uint32_t row) const {
+  auto rowBegin = rowWords(row);
+  uint32_t c = 0;
+  for (uint32_t w = 0; w < wordsPerRow; ++w) {
+    c += countPopulation(rowBegin[w]);
   }
 
-  return next - rowBegin;
+  return c;
 }
 
-void BitMatrix::transitiveClosure() {
-  uint32_t nAdd = 0;
+void BitMatrix::unionRows(uint32_t dstRow, uint32_t srcRow) {
+  auto dst = rowWords(dstRow);
+  auto src = rowWords(srcRow);
+  for (uint32_t w = 0; w < wordsPerRow; ++w) {
+    dst[w] |= src[w];
+  }
+}
+
+void BitMatrix::intersectRows(uint32_t dstRow, uint32_t srcRow) {
+  auto dst = rowWords(dstRow);
+  auto src = rowWords(srcRow);
+  for (uint32_t w = 0; w < wordsPerRow; ++w) {
+    dst[w] &= src[w];
+  }
+}
 
-  typedef std::list<uint32_t> Worklist;
-  Worklist worklist;
-  for (uint32_t i = 0; i < N; ++i) {
-    worklist.push_back(i);
+uint32_t BitMatrix::countRowsIntersection(uint32_t row1, uint32_t row2) const {
+  auto r1 = rowWords(row1);
+  auto r2 = rowWords(row2);
+  uint32_t c = 0;
+  for (uint32_t w = 0; w < wordsPerRow; ++w) {
+    c += countPopulation(r1[w] & r2[w]);
   }
 
-  while (!worklist.empty()) {
-    uint32_t i = worklist.front();
-    worklist.pop_front();
+  return c;
+}
 
-    bool changedI = false;
+void BitMatrix::transitiveClosure() {
 
-    // (i->j)
-    for (int32_t j = firstSuccessor(i); j != -1; j = nextSuccessor(i, j)) {
-      // bit-wise or row[i] |= row[j]
+  // Identify the strongly connected components of the relation (Tarjan).
+  // Components are completed in reverse topological order: when a component
+  // completes, the rows of every component it reaches are already closed.
+  // Hence, the closed row of a component is the union of the columns of its
+  // rows, and of the closed rows of the columns that belong to other
+  // components.
+  const uint32_t unvisited = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> visitNumber(N, unvisited);
+  std::vector<uint32_t> lowLink(N, unvisited);
+  std::vector<bool> completed(N, false);
+  std::vector<uint32_t> nodesOnStack;
+  std::vector<std::pair<uint32_t, int32_t>> visitStack;
+  std::vector<uint32_t> component;
+  std::vector<uint64_t> closedRow(wordsPerRow);
+  uint32_t visitCounter = 0;
+
+  auto visit = [&](uint32_t i) {
+    visitNumber[i] = visitCounter;
+    lowLink[i] = visitCounter;
+    ++visitCounter;
+    nodesOnStack.push_back(i);
+    visitStack.push_back(std::make_pair(i, firstSuccessor(i)));
+  };
+
+  for (uint32_t root = 0; root < N; ++root) {
+    if (visitNumber[root] != unvisited) {
+      continue;
+    }
 
-      // (j->k)
-      for (int32_t k = firstSuccessor(j); k != -1; k = nextSuccessor(j, k)) {
-        // but not (i->k)
-        if (!test(i, k)) {
-          changedI = true;
-          ++nAdd;
-          set(i, k);
+    visit(root);
+    while (!visitStack.empty()) {
+      const uint32_t i = visitStack.back().first;
+      const int32_t j = visitStack.back().second;
+
+      // (i->j)
+      if (j != -1) {
+        visitStack.back().second = nextSuccessor(i, j);
+        if (visitNumber[j] == unvisited) {
+          visit(j);
+        } else if (!completed[j]) {
+          lowLink[i] = std::min(lowLink[i], visitNumber[j]);
         }
+        continue;
       }
-    }
 
-    if (changedI) {
-      for (uint32_t p = 0; p < N; ++p) {
-        if (test(p, i)) {
-          if (std::find(worklist.begin(), worklist.end(), p) ==
-              worklist.end()) {
-            worklist.push_back(p);
+      // All successors of i have been visited
+      visitStack.pop_back();
+      if (!visitStack.empty()) {
+        const uint32_t parent = visitStack.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[i]);
+      }
+      if (lowLink[i] != visitNumber[i]) {
+        continue;
+      }
+
+      // i is the root of a component
+      component.clear();
+      uint32_t member;
+      do {
+        member = nodesOnStack.back();
+        nodesOnStack.pop_back();
+        component.push_back(member);
+      } while (member != i);
+
+      // Merge the rows of the successors of the component
+      std::fill(closedRow.begin(), closedRow.end(), 0);
+      for (auto m : component) {
+        auto mRow = rowWords(m);
+        for (uint32_t w = 0; w < wordsPerRow; ++w) {
+          closedRow[w] |= mRow[w];
+        }
+        for (int32_t k = firstSuccessor(m); k != -1; k = nextSuccessor(m, k)) {
+          if (completed[k]) {
+            auto kRow = rowWords(k);
+            for (uint32_t w = 0; w < wordsPerRow; ++w) {
+              closedRow[w] |= kRow[w];
+            }
           }
         }
       }
+      for (auto m : component) {
+        std::copy(closedRow.begin(), closedRow.end(), rowWords(m));
+        completed[m] = true;
+      }
     }
   }
 }
@@ -19,11 +19,13 @@ using namespace llvm;
 
 DomNodeSummary::DomNodeSummary (const DTAliases::Node &node) :
   B{node.getBlock()}, level{node.getLevel()},
-  parent{nullptr}, iDom{nullptr}, children{} {}
+  parent{nullptr}, iDom{nullptr}, children{},
+  dfsEntry{0}, dfsExit{0}, ancestors{} {}
 
 DomNodeSummary::DomNodeSummary (const DomNodeSummary &node) :
   B{node.getBlock()}, level{node.getLevel()},
-  parent{nullptr}, iDom{nullptr}, children{} {}
+  parent{nullptr}, iDom{nullptr}, children{},
+  dfsEntry{0}, dfsExit{0}, ancestors{} {}
 
 raw_ostream &DomNodeSummary::print (raw_ostream &stream, std::string prefix) {
   stream << prefix << "Block: ";
@@ -75,6 +77,8 @@ DomTreeSummary::DomTreeSummary (PostDominatorTree &PDT) :
 DomTreeSummary::DomTreeSummary (std::set<DTAliases::Node *> nodeSubset) :
   nodes{}, bbNodeMap{} {
   this->cloneNodes<DTAliases::Node>(nodeSubset);
+  this->numberNodes();
+  this->collectInstructionPositions();
 }
 
 DomTreeSummary::DomTreeSummary (DomTreeSummary &DTS, std::set<BasicBlock *> &bbSubset) :
@@ -83,19 +87,29 @@ DomTreeSummary::DomTreeSummary (DomTreeSummary &DTS, std::set<BasicBlock *> &bbS
 DomTreeSummary::DomTreeSummary (std::set<DomNodeSummary *> nodeSubset)
   : nodes{}, bbNodeMap{} {
   this->cloneNodes<DomNodeSummary>(nodeSubset);
+  this->numberNodes();
+  this->collectInstructionPositions();
 }
 
 DomTreeSummary::~DomTreeSummary () {
   for (auto node : nodes) delete node;
   nodes.clear();
   bbNodeMap.clear();
+  instructionPositions.clear();
 }
 
 void DomTreeSummary::transferToClones (std::unordered_map<BasicBlock *, BasicBlock *> &bbCloneMap) {
+  bbNodeMap.clear();
   for (auto node : nodes) {
     assert(bbCloneMap.find(node->B) != bbCloneMap.end());
     node->B = bbCloneMap[node->B];
+    bbNodeMap[node->B] = node;
   }
+
+  /*
+   * The tree is unchanged, so only the positions of the instructions need to be recomputed.
+   */
+  this->collectInstructionPositions();
 }
 
 template <typename TreeType>
@@ -170,6 +184,67 @@ void DomTreeSummary::cloneNodes (std::set<NodeType *> &nodesToClone) {
   }
 }
 
+void DomTreeSummary::numberNodes (void) {
+
+  /*
+   * Visit the trees of the summary in depth-first order.
+   * Parents are visited before their children, so the ancestors of a parent are known when its children are visited.
+   */
+  uint32_t counter = 0;
+  std::vector<std::pair<DomNodeSummary *, uint32_t>> stack;
+  for (auto root : this->nodes) {
+    if (root->parent != nullptr) continue;
+
+    root->dfsEntry = counter++;
+    root->ancestors.clear();
+    stack.push_back(std::make_pair(root, 0));
+    while (!stack.empty()) {
+      auto node = stack.back().first;
+      auto childIndex = stack.back().second;
+
+      /*
+       * Check if all children have been visited.
+       */
+      if (childIndex == node->children.size()) {
+        node->dfsExit = counter++;
+        stack.pop_back();
+        continue;
+      }
+      stack.back().second++;
+
+      /*
+       * Visit the next child.
+       */
+      auto child = node->children[childIndex];
+      child->dfsEntry = counter++;
+      child->ancestors.clear();
+      child->ancestors.push_back(node);
+      for (size_t i = 0; i < child->ancestors[i]->ancestors.size(); i++) {
+        auto ancestor = child->ancestors[i]->ancestors[i];
+        child->ancestors.push_back(ancestor);
+      }
+      stack.push_back(std::make_pair(child, 0));
+    }
+  }
+
+  return ;
+}
+
+void DomTreeSummary::collectInstructionPositions (void) {
+  this->instructionPositions.clear();
+  for (auto node : this->nodes) {
+    auto B = node->B;
+    if (B == nullptr) continue;
+
+    uint32_t position = 0;
+    for (auto &I : *B) {
+      this->instructionPositions[&I] = std::make_pair(B, position++);
+    }
+  }
+
+  return ;
+}
+
 DomNodeSummary *DomTreeSummary::getNode (BasicBlock *B) const {
   auto nodeIter = bbNodeMap.find(B);
   return nodeIter == bbNodeMap.end() ? nullptr : nodeIter->second;
@@ -178,6 +253,25 @@ DomNodeSummary *DomTreeSummary::getNode (BasicBlock *B) const {
 bool DomTreeSummary::dominates (Instruction *I, Instruction *J) const {
   BasicBlock *B1 = I->getParent(), *B2 = J->getParent();
   if (B1 == B2) {
+
+    /*
+     * Use the positions of the instructions captured when the summary was computed.
+     * They are valid as long as the instructions of the basic block have not been reordered or erased since then.
+     */
+    auto positionI = this->instructionPositions.find(I);
+    auto positionJ = this->instructionPositions.find(J);
+    if (  true
+          && (positionI != this->instructionPositions.end())
+          && (positionJ != this->instructionPositions.end())
+          && (positionI->second.first == B1)
+          && (positionJ->second.first == B2)
+      ){
+      return positionI->second.second <= positionJ->second.second;
+    }
+
+    /*
+     * The instructions have been added after the summary was computed.
+     */
     auto i = I;
     while (i != nullptr) {
       if (i == J) return true;
@@ -198,16 +292,7 @@ bool DomTreeSummary::dominates (BasicBlock *B1, BasicBlock *B2) const {
 }
 
 bool DomTreeSummary::dominates (DomNodeSummary *node1, DomNodeSummary *node2) const {
-  std::queue<DomNodeSummary *> worklist;
-  worklist.push(node1);
-  while (!worklist.empty()) {
-    auto node = worklist.front();
-    worklist.pop();
-
-    if (node == node2) return true;
-    for (auto child : node->children) worklist.push(child);
-  }
-  return false;
+  return (node1->dfsEntry <= node2->dfsEntry) && (node2->dfsExit <= node1->dfsExit);
 }
 
 std::set<DomNodeSummary *> DomTreeSummary::dominates (DomNodeSummary *node) const {
@@ -223,7 +308,8 @@ BasicBlock *DomTreeSummary::findNearestCommonDominator (
   BasicBlock *B1,
   BasicBlock *B2
 ) const {
-  return findNearestCommonDominator(this->getNode(B1), this->getNode(B2))->B;
+  auto node = findNearestCommonDominator(this->getNode(B1), this->getNode(B2));
+  return node == nullptr ? nullptr : node->B;
 }
 
 DomNodeSummary *DomTreeSummary::findNearestCommonDominator (
@@ -232,19 +318,25 @@ DomNodeSummary *DomTreeSummary::findNearestCommonDominator (
 ) const {
 
   /*
-   * Helpers to determine whether a node n dominates node2
+   * Check if one node dominates the other one.
    */
-  auto dominatorsOf2 = this->dominates(node2);
-  auto dominates2 = [&](DomNodeSummary *node) -> bool {
-    return dominatorsOf2.find(node) != dominatorsOf2.end();
-  };
+  if (this->dominates(node1, node2)) return node1;
+  if (this->dominates(node2, node1)) return node2;
 
   /*
-   * Traversal of parents of node1 to find common dominator
+   * Climb from node1 to the highest ancestor that does not dominate node2.
+   * Its parent is the nearest common dominator (nullptr if node1 and node2 belong to different trees of the summary).
    */
-  DomNodeSummary *node = node1;
-  while (node && !dominates2(node)) node = node->parent;
-  return node;
+  auto node = node1;
+  for (size_t i = node->ancestors.size(); i > 0; i--) {
+    auto ancestorIndex = i - 1;
+    if (ancestorIndex >= node->ancestors.size()) continue;
+    auto ancestor = node->ancestors[ancestorIndex];
+    if (this->dominates(ancestor, node2)) continue;
+    node = ancestor;
+  }
+
+  return node->parent;
 }
 
 raw_ostream &DomTreeSummary::print (raw_ostream &stream, std::string prefixToUse) const {
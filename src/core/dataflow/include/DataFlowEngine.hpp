@@ -13,6 +13,7 @@
 #include "SystemHeaders.hpp"
 
 #include "DataFlowResult.hpp"
+#include "DataFlowWorklist.hpp"
 
 namespace llvm {
 
@@ -24,6 +25,20 @@ namespace llvm {
        */
       DataFlowEngine ();
 
+      /*
+       * Statistics about how an analysis converged.
+       */
+      struct ConvergenceStatistics {
+        Function *f;
+        uint64_t numberOfBasicBlocks;
+        uint64_t numberOfBasicBlockEvaluations;
+      };
+
+      /*
+       * Invoke @hook at the end of every analysis run by this engine.
+       */
+      void setConvergenceStatisticsHook (std::function<void (ConvergenceStatistics const &statistics)> hook);
+
       DataFlowResult * applyForward (
         Function *f,
         std::function<void (Instruction *, DataFlowResult *)> computeGEN,
@@ -42,6 +57,31 @@ namespace llvm {
         std::function<void (std::set<Value *>& OUT, Instruction *successor, DataFlowResult *df)> computeOUT
         ) ;
 
+      /*
+       * Backward analysis on a dense result (see DataFlowResult).
+       *
+       * The data-flow sets can only include instructions for which isInUniverse holds.
+       * computeGEN and computeKILL set the bits of denseGEN and denseKILL (see DataFlowResult::getUniverseIndex).
+       * Then, IN[i] = GEN[i] U (OUT[i] - KILL[i]) and OUT[i] is the union of IN[s] for every successor s of i such that propagateFrom(s) holds.
+       */
+      DataFlowResult * applyDenseBackward (
+        Function *f,
+        std::function<bool (Instruction *)> isInUniverse,
+        std::function<void (Instruction *, DataFlowResult *)> computeGEN,
+        std::function<void (Instruction *, DataFlowResult *)> computeKILL,
+        std::function<bool (Instruction *successor)> propagateFrom
+        ) ;
+
+      /*
+       * Backward analysis on a dense result where every instruction of @f can belong to the data-flow sets.
+       */
+      DataFlowResult * applyDenseBackward (
+        Function *f,
+        std::function<void (Instruction *, DataFlowResult *)> computeGEN,
+        std::function<void (Instruction *, DataFlowResult *)> computeKILL,
+        std::function<bool (Instruction *successor)> propagateFrom
+        ) ;
+
     protected:
       void computeGENAndKILL (
         Function *f, 
@@ -59,10 +99,13 @@ namespace llvm {
         std::function<void (Instruction *inst, std::set<Value *>& OUT)> initializeOUT,
         std::function<void (Instruction *inst, std::set<Value *>& IN, Instruction *predecessor, DataFlowResult *df)> computeIN,
         std::function<void (Instruction *inst, std::set<Value *>& OUT, DataFlowResult *df)> computeOUT,
-        std::function<void (std::list<BasicBlock *> &workingList, BasicBlock *bb)> appendBB,
         std::function<Instruction * (BasicBlock *bb)> getFirstInstruction,
         std::function<Instruction * (BasicBlock *bb)> getLastInstruction
         );
+
+      void reportConvergence (Function *f, DataFlowWorklist &workingList, uint64_t numberOfBasicBlockEvaluations);
+
+      std::function<void (ConvergenceStatistics const &statistics)> convergenceStatisticsHook;
   };
 
 }
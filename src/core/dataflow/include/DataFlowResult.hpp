@@ -11,9 +11,69 @@
 #pragma once
 
 #include "SystemHeaders.hpp"
+#include "llvm/ADT/SparseBitVector.h"
 
 namespace llvm {
 
+  /*
+   * Values of a data-flow set.
+   *
+   * The set is either an explicit list of values or the symbolic set of all instructions of a function.
+   * The latter costs O(1) memory: its instructions are never stored and they are iterated lazily.
+   */
+  class DataFlowSet {
+    public:
+      class iterator {
+        public:
+          using iterator_category = std::forward_iterator_tag;
+          using value_type = Value *;
+          using difference_type = std::ptrdiff_t;
+          using pointer = Value **;
+          using reference = Value *;
+
+          iterator (std::vector<Value *>::const_iterator valueIt);
+
+          iterator (Function::iterator bbIt, Function::iterator bbEnd);
+
+          Value * operator* (void) const ;
+
+          iterator & operator++ (void);
+
+          bool operator== (const iterator &other) const ;
+
+          bool operator!= (const iterator &other) const ;
+
+        private:
+          bool symbolic;
+          std::vector<Value *>::const_iterator valueIt;
+          Function::iterator bbIt;
+          Function::iterator bbEnd;
+          BasicBlock::iterator instIt;
+      };
+
+      DataFlowSet ();
+
+      /*
+       * Create the symbolic set of all instructions of @f.
+       */
+      DataFlowSet (Function *f);
+
+      /*
+       * Add @value to an explicit set.
+       */
+      void insert (Value *value);
+
+      bool isSymbolic (void) const ;
+
+      iterator begin (void) const ;
+
+      iterator end (void) const ;
+
+    private:
+      Function *f;
+      std::vector<Value *> values;
+  };
+
   class DataFlowResult {
     public:
 
@@ -22,16 +82,95 @@ namespace llvm {
        */
       DataFlowResult ();
 
+      /*
+       * Create a dense result for @f where every instruction of @f can belong to a data-flow set.
+       */
+      DataFlowResult (Function *f);
+
+      /*
+       * Create a dense result for @f.
+       * The instructions of @f are numbered once to index their data-flow sets.
+       * The instructions that can belong to a data-flow set (i.e., those for which @isInUniverse holds) are numbered separately, and the sets are bit vectors indexed by these numbers.
+       * Hence, IN and OUT cost one bit per instruction of the universe rather than one bit per instruction of @f.
+       */
+      DataFlowResult (Function *f, std::function<bool (Instruction *)> isInUniverse);
+
+      /*
+       * Create a result for @f where IN and OUT of every instruction are the set of all instructions of @f.
+       * These sets are symbolic (see DataFlowSet) unless they are requested through IN and OUT.
+       */
+      DataFlowResult (Function *f, bool fullSets);
+
+      /*
+       * For a dense result or a result with full sets, these sets are built the first time they are requested.
+       * Changing them does not change the result.
+       */
       std::set<Value *>& GEN (Instruction *inst);
       std::set<Value *>& KILL (Instruction *inst);
       std::set<Value *>& IN (Instruction *inst);
       std::set<Value *>& OUT (Instruction *inst);
 
+      /*
+       * Query OUT[inst] without building the set for dense results and results with full sets.
+       */
+      bool doesOUTContain (Instruction *inst, Value *value);
+
+      bool iterateOverOUT (Instruction *inst, std::function<bool (Value *value)> funcToInvoke);
+
+      bool hasFullSets (void) const ;
+
+      /*
+       * Dense representation.
+       */
+      bool isDense (void) const ;
+
+      uint32_t getNumberOfInstructions (void) const ;
+
+      uint32_t getIndex (Instruction *inst) const ;
+
+      Instruction * getInstruction (uint32_t index) const ;
+
+      /*
+       * Bits of the dense sets.
+       */
+      uint32_t getUniverseSize (void) const ;
+
+      uint32_t getUniverseIndex (Instruction *inst) const ;
+
+      Instruction * getUniverseInstruction (uint32_t index) const ;
+
+      SparseBitVector<> & denseGEN (Instruction *inst);
+      SparseBitVector<> & denseKILL (Instruction *inst);
+      BitVector & denseIN (Instruction *inst);
+
+      /*
+       * OUT of an instruction that is not a terminator is IN of the next instruction.
+       */
+      BitVector & denseOUT (Instruction *inst);
+
     private:
       std::map<Instruction *, std::set<Value *>> gens;
       std::map<Instruction *, std::set<Value *>> kills;
       std::map<Instruction *, std::set<Value *>> ins;
       std::map<Instruction *, std::set<Value *>> outs;
+
+      bool dense;
+      Function *fullSetsFunction;
+      std::vector<Instruction *> instructions;
+      std::unordered_map<Instruction *, uint32_t> indices;
+      std::vector<Instruction *> universe;
+      std::unordered_map<Instruction *, uint32_t> universeIndices;
+      std::vector<SparseBitVector<>> denseGens;
+      std::vector<SparseBitVector<>> denseKills;
+      std::vector<BitVector> denseIns;
+      std::vector<BitVector> denseOuts;
+
+      std::set<Value *>& getSet (
+        std::map<Instruction *, std::set<Value *>> &sets,
+        Instruction *inst,
+        std::function<void (uint32_t index, std::set<Value *> &s)> fillFromDense,
+        bool isFull
+        );
   };
 
 }
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2016 - 2019  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "SystemHeaders.hpp"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/IR/CFG.h"
+
+namespace llvm {
+
+  /*
+   * Working list of basic blocks of a data-flow analysis.
+   *
+   * Basic blocks are popped in priority order: reverse post-order for forward analyses and post-order for backward ones.
+   * Hence, a basic block is usually processed after the ones that provide its inputs.
+   * A basic block is never included more than once.
+   */
+  class DataFlowWorklist {
+    public:
+
+      /*
+       * Methods
+       */
+      DataFlowWorklist (Function *f, bool isForward);
+
+      void push (BasicBlock *bb);
+
+      BasicBlock * pop (void);
+
+      bool isEmpty (void) const ;
+
+      uint32_t getNumberOfBasicBlocks (void) const ;
+
+      /*
+       * Position of @bb in the priority order.
+       * It can be used to index per-basic-block data.
+       */
+      uint32_t getPriority (BasicBlock *bb) const ;
+
+    private:
+      std::vector<BasicBlock *> order;
+      std::unordered_map<BasicBlock *, uint32_t> priorities;
+      std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> queue;
+      BitVector included;
+  };
+
+}
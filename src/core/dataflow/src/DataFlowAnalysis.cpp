@@ -20,15 +20,10 @@ DataFlowResult * DataFlowAnalysis::getFullSets (
     Function *f)
   {
 
-  auto df = new DataFlowResult{};
-  for (auto& inst : instructions(*f)){
-    auto& inSetOfInst = df->IN(&inst);
-    auto& outSetOfInst = df->OUT(&inst);
-    for (auto& inst2 : instructions(*f)){
-      inSetOfInst.insert(&inst2);
-      outSetOfInst.insert(&inst2);
-    }
-  }
+  /*
+   * The sets are symbolic: no instruction is stored.
+   */
+  auto df = new DataFlowResult{f, true};
 
   return df;
 }
@@ -58,36 +53,26 @@ DataFlowResult * DataFlowAnalysis::runReachableAnalysis (
     /*
      * Add the instruction to the GEN set.
      */
-    auto& gen = df->GEN(i);
-    gen.insert(i);
+    auto& gen = df->denseGEN(i);
+    gen.set(df->getUniverseIndex(i));
 
     return ;
   };
   auto computeKILL = [](Instruction *, DataFlowResult *) {
     return ;
   };
-  auto computeOUT = [](std::set<Value *>& OUT, Instruction *succ, DataFlowResult *df) {
-    auto& inS = df->IN(succ);
-    OUT.insert(inS.begin(), inS.end());
-    return ;
-  } ;
-  auto computeIN = [](std::set<Value *>& IN, Instruction *inst, DataFlowResult *df) {
-    auto& genI = df->GEN(inst);
-    auto& outI = df->OUT(inst);
-
-    /*
-     * IN[i] = GEN[i] U OUT[i]
-     */
-    IN.insert(genI.begin(), genI.end());
-    IN.insert(outI.begin(), outI.end());
-
-    return ;
+  auto propagateFrom = [](Instruction *succ) -> bool {
+    return true;
   };
 
   /*
    * Run the data flow analysis needed to identify the instructions that could be executed from a given point.
+   *
+   * IN[i] = GEN[i] U OUT[i]
+   *
+   * Only the instructions that pass the filter can be in these sets, so they are the only ones numbered as bits.
    */
-  auto df = dfa.applyBackward(f, computeGEN, computeKILL, computeIN, computeOUT);
+  auto df = dfa.applyDenseBackward(f, filter, computeGEN, computeKILL, propagateFrom);
 
   return df;
 }
@@ -16,6 +16,26 @@ DataFlowEngine::DataFlowEngine (){
   return ;
 }
 
+void DataFlowEngine::setConvergenceStatisticsHook (std::function<void (ConvergenceStatistics const &statistics)> hook){
+  this->convergenceStatisticsHook = hook;
+
+  return ;
+}
+
+void DataFlowEngine::reportConvergence (Function *f, DataFlowWorklist &workingList, uint64_t numberOfBasicBlockEvaluations){
+  if (!this->convergenceStatisticsHook){
+    return ;
+  }
+
+  ConvergenceStatistics statistics;
+  statistics.f = f;
+  statistics.numberOfBasicBlocks = workingList.getNumberOfBasicBlocks();
+  statistics.numberOfBasicBlockEvaluations = numberOfBasicBlockEvaluations;
+  this->convergenceStatisticsHook(statistics);
+
+  return ;
+}
+
 DataFlowResult * DataFlowEngine::applyForward (
     Function *f,
     std::function<void (Instruction *, DataFlowResult *)> computeGEN,
@@ -29,10 +49,6 @@ DataFlowResult * DataFlowEngine::applyForward (
   /*
    * Define the customization.
    */
-  auto appendBB = [](std::list<BasicBlock *> &workingList, BasicBlock *bb){ 
-    workingList.push_back(bb);
-  };
-
   auto getFirstInst = [](BasicBlock *bb) -> Instruction *{
     return &*bb->begin();
   };
@@ -51,7 +67,6 @@ DataFlowResult * DataFlowEngine::applyForward (
       initializeOUT, 
       computeIN, 
       computeOUT,
-      appendBB,
       getFirstInst,
       getLastInst
       );
@@ -77,23 +92,23 @@ DataFlowResult * DataFlowEngine::applyBackward (
    * Compute the IN and OUT
    *
    * Create the working list by adding all basic blocks to it.
+   * Basic blocks are processed in post-order so that successors are processed before their predecessors.
    */
-  std::unordered_set<BasicBlock *> computedOnce;
-  std::list<BasicBlock *> workingList;
-  for (auto& bb : *f){
-    workingList.push_front(&bb);
-  }
+  DataFlowWorklist workingList(f, false);
+  BitVector computedOnce(workingList.getNumberOfBasicBlocks(), false);
+  uint64_t evaluations = 0;
 
   /* 
    * Compute the INs and OUTs iteratively until the working list is empty.
    */
-  while (!workingList.empty()){
+  while (!workingList.isEmpty()){
 
     /* 
      * Fetch a basic block that needs to be processed.
      */
-    auto bb = workingList.front();
-    workingList.pop_front();
+    auto bb = workingList.pop();
+    auto bbPriority = workingList.getPriority(bb);
+    evaluations++;
 
     /* 
      * Fetch the last instruction of the current basic block.
@@ -135,13 +150,13 @@ DataFlowResult * DataFlowEngine::applyBackward (
      */
     if (  false
         || (inSetOfInst.size() > oldSize)
-        || (computedOnce.find(bb) == computedOnce.end())
+        || !computedOnce.test(bbPriority)
        ){
 
       /*
        * Remember that we have now computed this basic block.
        */
-      computedOnce.insert(bb);
+      computedOnce.set(bbPriority);
 
       /* 
        * Propagate the new IN[inst] to the rest of the instructions of the current basic block.
@@ -182,10 +197,133 @@ DataFlowResult * DataFlowEngine::applyBackward (
        * Add predecessors of the current basic block to the working list.
        */
       for (auto predBB : predecessors(bb)){
-        workingList.push_back(predBB);
+        workingList.push(predBB);
       }
     }
   }
+  this->reportConvergence(f, workingList, evaluations);
+
+  return df;
+}
+
+DataFlowResult * DataFlowEngine::applyDenseBackward (
+    Function *f,
+    std::function<void (Instruction *, DataFlowResult *)> computeGEN,
+    std::function<void (Instruction *, DataFlowResult *)> computeKILL,
+    std::function<bool (Instruction *successor)> propagateFrom
+    ){
+
+  /*
+   * Every instruction can belong to the data-flow sets.
+   */
+  auto allInstructions = [](Instruction *) -> bool {
+    return true;
+  };
+
+  return this->applyDenseBackward(f, allInstructions, computeGEN, computeKILL, propagateFrom);
+}
+
+DataFlowResult * DataFlowEngine::applyDenseBackward (
+    Function *f,
+    std::function<bool (Instruction *)> isInUniverse,
+    std::function<void (Instruction *, DataFlowResult *)> computeGEN,
+    std::function<void (Instruction *, DataFlowResult *)> computeKILL,
+    std::function<bool (Instruction *successor)> propagateFrom
+    ){
+
+  /*
+   * Number the instructions and compute the GENs and KILLs
+   */
+  auto df = new DataFlowResult{f, isInUniverse};
+  computeGENAndKILL(f, computeGEN, computeKILL, df);
+
+  /*
+   * Define the transfer function: IN[i] = GEN[i] U (OUT[i] - KILL[i])
+   */
+  auto computeIN = [df](Instruction *i, BitVector &IN){
+    IN = df->denseOUT(i);
+    for (auto bit : df->denseKILL(i)){
+      IN.reset(bit);
+    }
+    for (auto bit : df->denseGEN(i)){
+      IN.set(bit);
+    }
+  };
+
+  /*
+   * Compute the IN and OUT
+   *
+   * Create the working list by adding all basic blocks to it.
+   * Basic blocks are processed in post-order so that successors are processed before their predecessors.
+   */
+  DataFlowWorklist workingList(f, false);
+  BitVector computedOnce(workingList.getNumberOfBasicBlocks(), false);
+  uint64_t evaluations = 0;
+
+  /* 
+   * Compute the INs and OUTs iteratively until the working list is empty.
+   */
+  BitVector oldIN;
+  while (!workingList.isEmpty()){
+
+    /* 
+     * Fetch a basic block that needs to be processed.
+     */
+    auto bb = workingList.pop();
+    auto bbPriority = workingList.getPriority(bb);
+    evaluations++;
+
+    /* 
+     * Compute OUT of the terminator as the union of the INs of the first instruction of its successors.
+     */
+    auto inst = bb->getTerminator();
+    auto& outSetOfInst = df->denseOUT(inst);
+    for (auto successorBB : successors(bb)){
+      auto successorInst = &*successorBB->begin();
+      if (!propagateFrom(successorInst)){
+        continue ;
+      }
+      outSetOfInst |= df->denseIN(successorInst);
+    }
+
+    /* 
+     * Compute the INs of the instructions of the basic block, from the last one to the first one.
+     * Notice that OUT of an instruction that isn't the terminator is IN of the next one, which has already been computed.
+     */
+    auto firstInst = &*bb->begin();
+    oldIN = df->denseIN(firstInst);
+    BasicBlock::iterator iter(inst);
+    while (true){
+      auto i = &*iter;
+      computeIN(i, df->denseIN(i));
+      if (iter == bb->begin()){
+        break ;
+      }
+      iter--;
+    }
+
+    /* 
+     * Check if IN of the basic block changed.
+     */
+    if (  false
+        || (df->denseIN(firstInst) != oldIN)
+        || !computedOnce.test(bbPriority)
+       ){
+
+      /*
+       * Remember that we have now computed this basic block.
+       */
+      computedOnce.set(bbPriority);
+
+      /* 
+       * Add predecessors of the current basic block to the working list.
+       */
+      for (auto predBB : predecessors(bb)){
+        workingList.push(predBB);
+      }
+    }
+  }
+  this->reportConvergence(f, workingList, evaluations);
 
   return df;
 }
@@ -218,7 +356,6 @@ DataFlowResult * DataFlowEngine::applyCustomizableForwardAnalysis (
     std::function<void (Instruction *inst, std::set<Value *>& OUT)> initializeOUT,
     std::function<void (Instruction *inst, std::set<Value *>& IN, Instruction *predecessor, DataFlowResult *df)> computeIN,
     std::function<void (Instruction *inst, std::set<Value *>& OUT, DataFlowResult *df)> computeOUT,
-    std::function<void (std::list<BasicBlock *> &workingList, BasicBlock *bb)> appendBB,
     std::function<Instruction * (BasicBlock *bb)> getFirstInstruction,
     std::function<Instruction * (BasicBlock *bb)> getLastInstruction
     ){
@@ -245,31 +382,23 @@ DataFlowResult * DataFlowEngine::applyCustomizableForwardAnalysis (
    * Compute the IN and OUT
    *
    * Create the working list by adding all basic blocks to it.
+   * Basic blocks are processed in reverse post-order so that predecessors are processed before their successors.
    */
-  std::list<BasicBlock *> workingList;
-  std::unordered_map<BasicBlock *, bool> worklingListContent;
-  for (auto& bb : *f){
-    appendBB(workingList, &bb);
-    worklingListContent[&bb] = true;
-  }
+  DataFlowWorklist workingList(f, true);
+  BitVector alreadyVisited(workingList.getNumberOfBasicBlocks(), false);
+  uint64_t evaluations = 0;
 
   /* 
    * Compute the INs and OUTs iteratively until the working list is empty.
    */
-  std::unordered_map<Instruction *, bool> alreadyVisited;
-  while (!workingList.empty()){
+  while (!workingList.isEmpty()){
 
     /* 
      * Fetch a basic block that needs to be processed.
      */
-    auto bb = workingList.front();
-    assert(worklingListContent[bb] == true);
-
-    /*
-     * Remove the basic block from the workingList.
-     */
-    workingList.pop_front();
-    worklingListContent[bb] = false;
+    auto bb = workingList.pop();
+    auto bbPriority = workingList.getPriority(bb);
+    evaluations++;
 
     /* 
      * Fetch the first instruction of the basic block.
@@ -309,10 +438,10 @@ DataFlowResult * DataFlowEngine::applyCustomizableForwardAnalysis (
     /* Check if the OUT of the first instruction of the current basic block changed.
     */
     if (  false
-        || (!alreadyVisited[inst])
+        || !alreadyVisited.test(bbPriority)
         || (outSetOfInst.size() != oldSize)
        ){
-      alreadyVisited[inst] = true;
+      alreadyVisited.set(bbPriority);
 
       /* 
        * Propagate the new OUT[inst] to the rest of the instructions of the current basic block.
@@ -354,14 +483,11 @@ DataFlowResult * DataFlowEngine::applyCustomizableForwardAnalysis (
        * Add successors of the current basic block to the working list.
        */
       for (auto succBB : successors(bb)){
-        if (worklingListContent[succBB] == true){
-          continue ;
-        }
-        workingList.push_back(succBB);
-        worklingListContent[succBB] = true;
+        workingList.push(succBB);
       }
     }
   }
+  this->reportConvergence(f, workingList, evaluations);
 
   return df;
 }
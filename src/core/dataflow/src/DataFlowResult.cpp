@@ -12,30 +12,349 @@
 
 using namespace llvm ;
 
-DataFlowResult::DataFlowResult (){
+DataFlowSet::DataFlowSet ()
+  : f{nullptr}
+  {
   return ;
 }
 
-std::set<Value *>& DataFlowResult::GEN (Instruction *inst){
-  auto& s = this->gens[inst];
+DataFlowSet::DataFlowSet (Function *f)
+  : f{f}
+  {
+  return ;
+}
 
-  return s;
+void DataFlowSet::insert (Value *value){
+  assert(!this->isSymbolic());
+  this->values.push_back(value);
+
+  return ;
 }
 
-std::set<Value *>& DataFlowResult::KILL (Instruction *inst){
-  auto& s = this->kills[inst];
+bool DataFlowSet::isSymbolic (void) const {
+  return this->f != nullptr;
+}
 
-  return s;
+DataFlowSet::iterator DataFlowSet::begin (void) const {
+  if (!this->isSymbolic()){
+    return iterator(this->values.cbegin());
+  }
+
+  return iterator(this->f->begin(), this->f->end());
 }
 
-std::set<Value *>& DataFlowResult::IN (Instruction *inst){
-  auto& s = this->ins[inst];
+DataFlowSet::iterator DataFlowSet::end (void) const {
+  if (!this->isSymbolic()){
+    return iterator(this->values.cend());
+  }
 
-  return s;
+  return iterator(this->f->end(), this->f->end());
+}
+
+DataFlowSet::iterator::iterator (std::vector<Value *>::const_iterator valueIt)
+  : symbolic{false}, valueIt{valueIt}
+  {
+  return ;
+}
+
+DataFlowSet::iterator::iterator (Function::iterator bbIt, Function::iterator bbEnd)
+  : symbolic{true}, bbIt{bbIt}, bbEnd{bbEnd}
+  {
+  if (this->bbIt != this->bbEnd){
+    this->instIt = this->bbIt->begin();
+  }
+
+  return ;
+}
+
+Value * DataFlowSet::iterator::operator* (void) const {
+  if (!this->symbolic){
+    return *this->valueIt;
+  }
+
+  return &*this->instIt;
+}
+
+DataFlowSet::iterator & DataFlowSet::iterator::operator++ (void){
+  if (!this->symbolic){
+    ++this->valueIt;
+    return *this;
+  }
+
+  /*
+   * Move to the next instruction, which can belong to the next basic block.
+   */
+  ++this->instIt;
+  if (this->instIt == this->bbIt->end()){
+    ++this->bbIt;
+    if (this->bbIt != this->bbEnd){
+      this->instIt = this->bbIt->begin();
+    }
+  }
+
+  return *this;
+}
+
+bool DataFlowSet::iterator::operator== (const iterator &other) const {
+  if (!this->symbolic){
+    return this->valueIt == other.valueIt;
+  }
+
+  /*
+   * The instruction iterator is meaningless at the end of the function.
+   */
+  if (this->bbIt != other.bbIt){
+    return false;
+  }
+
+  return (this->bbIt == this->bbEnd) || (this->instIt == other.instIt);
+}
+
+bool DataFlowSet::iterator::operator!= (const iterator &other) const {
+  return !(*this == other);
+}
+
+DataFlowResult::DataFlowResult ()
+  : dense{false}, fullSetsFunction{nullptr}
+  {
+  return ;
+}
+
+DataFlowResult::DataFlowResult (Function *f, bool fullSets)
+  : dense{false}, fullSetsFunction{f}
+  {
+  assert(fullSets);
+
+  return ;
+}
+
+DataFlowResult::DataFlowResult (Function *f)
+  : DataFlowResult(f, std::function<bool (Instruction *)>([](Instruction *) -> bool { return true; }))
+  {
+  return ;
+}
+
+DataFlowResult::DataFlowResult (Function *f, std::function<bool (Instruction *)> isInUniverse)
+  : dense{true}, fullSetsFunction{nullptr}
+  {
+
+  /*
+   * Number the instructions of the function and those that can belong to a data-flow set.
+   */
+  for (auto &inst : llvm::instructions(*f)){
+    this->indices[&inst] = this->instructions.size();
+    this->instructions.push_back(&inst);
+    if (isInUniverse(&inst)){
+      this->universeIndices[&inst] = this->universe.size();
+      this->universe.push_back(&inst);
+    }
+  }
+
+  /*
+   * Allocate the dense sets.
+   *
+   * Within a basic block, OUT[i] is IN of the instruction that follows i (independently of the direction of the analysis).
+   * Hence, we allocate OUT only for terminators.
+   */
+  auto n = this->instructions.size();
+  auto m = this->universe.size();
+  this->denseGens.resize(n);
+  this->denseKills.resize(n);
+  this->denseIns.resize(n, BitVector(m, false));
+  this->denseOuts.resize(n);
+  for (auto index = 0; index < n; index++){
+    if (this->instructions[index]->isTerminator()){
+      this->denseOuts[index].resize(m, false);
+    }
+  }
+
+  return ;
+}
+
+std::set<Value *>& DataFlowResult::GEN (Instruction *inst){
+  return this->getSet(this->gens, inst, [this](uint32_t index, std::set<Value *> &s){
+    for (auto bit : this->denseGens[index]){
+      s.insert(this->universe[bit]);
+    }
+  }, false);
+}
+
+std::set<Value *>& DataFlowResult::KILL (Instruction *inst){
+  return this->getSet(this->kills, inst, [this](uint32_t index, std::set<Value *> &s){
+    for (auto bit : this->denseKills[index]){
+      s.insert(this->universe[bit]);
+    }
+  }, false);
+}
+
+std::set<Value *>& DataFlowResult::IN (Instruction *inst){
+  return this->getSet(this->ins, inst, [this](uint32_t index, std::set<Value *> &s){
+    for (auto bit : this->denseIns[index].set_bits()){
+      s.insert(this->universe[bit]);
+    }
+  }, true);
 }
 
 std::set<Value *>& DataFlowResult::OUT (Instruction *inst){
-  auto& s = this->outs[inst];
+  return this->getSet(this->outs, inst, [this](uint32_t index, std::set<Value *> &s){
+    for (auto bit : this->denseOUT(this->instructions[index]).set_bits()){
+      s.insert(this->universe[bit]);
+    }
+  }, true);
+}
+
+bool DataFlowResult::doesOUTContain (Instruction *inst, Value *value){
+  if (this->hasFullSets()){
+    auto valueInst = dyn_cast<Instruction>(value);
+    return (valueInst != nullptr) && (valueInst->getFunction() == this->fullSetsFunction);
+  }
+  if (!this->dense){
+    auto& s = this->OUT(inst);
+    return s.find(value) != s.end();
+  }
+
+  /*
+   * Only instructions of the universe can belong to a dense set.
+   */
+  auto valueInst = dyn_cast<Instruction>(value);
+  if (valueInst == nullptr){
+    return false;
+  }
+  auto it = this->universeIndices.find(valueInst);
+  if (it == this->universeIndices.end()){
+    return false;
+  }
+
+  return this->denseOUT(inst).test(it->second);
+}
+
+bool DataFlowResult::iterateOverOUT (Instruction *inst, std::function<bool (Value *value)> funcToInvoke){
+  if (this->hasFullSets()){
+    for (auto &i : llvm::instructions(*this->fullSetsFunction)){
+      if (funcToInvoke(&i)){
+        return true;
+      }
+    }
+    return false;
+  }
+  if (!this->dense){
+    for (auto value : this->OUT(inst)){
+      if (funcToInvoke(value)){
+        return true;
+      }
+    }
+    return false;
+  }
+
+  for (auto bit : this->denseOUT(inst).set_bits()){
+    if (funcToInvoke(this->universe[bit])){
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool DataFlowResult::hasFullSets (void) const {
+  return this->fullSetsFunction != nullptr;
+}
+
+bool DataFlowResult::isDense (void) const {
+  return this->dense;
+}
+
+uint32_t DataFlowResult::getNumberOfInstructions (void) const {
+  return this->instructions.size();
+}
+
+uint32_t DataFlowResult::getIndex (Instruction *inst) const {
+  assert(this->dense);
+  assert(this->indices.find(inst) != this->indices.end());
+
+  return this->indices.at(inst);
+}
+
+Instruction * DataFlowResult::getInstruction (uint32_t index) const {
+  assert(this->dense);
+  assert(index < this->instructions.size());
+
+  return this->instructions[index];
+}
+
+uint32_t DataFlowResult::getUniverseSize (void) const {
+  return this->universe.size();
+}
+
+uint32_t DataFlowResult::getUniverseIndex (Instruction *inst) const {
+  assert(this->dense);
+  assert(this->universeIndices.find(inst) != this->universeIndices.end());
+
+  return this->universeIndices.at(inst);
+}
+
+Instruction * DataFlowResult::getUniverseInstruction (uint32_t index) const {
+  assert(this->dense);
+  assert(index < this->universe.size());
+
+  return this->universe[index];
+}
+
+SparseBitVector<> & DataFlowResult::denseGEN (Instruction *inst){
+  return this->denseGens[this->getIndex(inst)];
+}
+
+SparseBitVector<> & DataFlowResult::denseKILL (Instruction *inst){
+  return this->denseKills[this->getIndex(inst)];
+}
+
+BitVector & DataFlowResult::denseIN (Instruction *inst){
+  return this->denseIns[this->getIndex(inst)];
+}
+
+BitVector & DataFlowResult::denseOUT (Instruction *inst){
+  auto index = this->getIndex(inst);
+  if (!inst->isTerminator()){
+    return this->denseIns[index + 1];
+  }
+
+  return this->denseOuts[index];
+}
+
+std::set<Value *>& DataFlowResult::getSet (
+  std::map<Instruction *, std::set<Value *>> &sets,
+  Instruction *inst,
+  std::function<void (uint32_t index, std::set<Value *> &s)> fillFromDense,
+  bool isFull
+  ){
+
+  /*
+   * Check if the set already exists.
+   */
+  auto it = sets.find(inst);
+  if (it != sets.end()){
+    return it->second;
+  }
+
+  /*
+   * Create the set.
+   * For results with full sets, IN and OUT include all instructions of the function.
+   * For dense results, the set is built from the bit vector of @inst (if @inst has been numbered).
+   */
+  auto& s = sets[inst];
+  if (  true
+        && isFull
+        && this->hasFullSets()
+    ){
+    for (auto &i : llvm::instructions(*this->fullSetsFunction)){
+      s.insert(&i);
+    }
+  }
+  if (  true
+        && this->dense
+        && (this->indices.find(inst) != this->indices.end())
+    ){
+    fillFromDense(this->indices[inst], s);
+  }
 
   return s;
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 - 2019  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "DataFlowWorklist.hpp"
+
+using namespace llvm ;
+
+DataFlowWorklist::DataFlowWorklist (Function *f, bool isForward){
+
+  /*
+   * Compute the post-order of the basic blocks reachable from the entry.
+   * Unreachable basic blocks go at the end, in layout order.
+   */
+  std::unordered_set<BasicBlock *> reachable;
+  for (auto bb : post_order(&f->getEntryBlock())){
+    this->order.push_back(bb);
+    reachable.insert(bb);
+  }
+  if (isForward){
+    std::reverse(this->order.begin(), this->order.end());
+  }
+  for (auto &bb : *f){
+    if (reachable.find(&bb) != reachable.end()){
+      continue ;
+    }
+    this->order.push_back(&bb);
+  }
+
+  /*
+   * Assign the priorities and add all basic blocks to the working list.
+   */
+  this->included.resize(this->order.size());
+  for (uint32_t i = 0; i < this->order.size(); i++){
+    this->priorities[this->order[i]] = i;
+    this->push(this->order[i]);
+  }
+
+  return ;
+}
+
+void DataFlowWorklist::push (BasicBlock *bb){
+  auto priority = this->getPriority(bb);
+  if (this->included.test(priority)){
+    return ;
+  }
+  this->included.set(priority);
+  this->queue.push(priority);
+
+  return ;
+}
+
+BasicBlock * DataFlowWorklist::pop (void){
+  assert(!this->isEmpty());
+
+  auto priority = this->queue.top();
+  this->queue.pop();
+  this->included.reset(priority);
+
+  return this->order[priority];
+}
+
+bool DataFlowWorklist::isEmpty (void) const {
+  return this->queue.empty();
+}
+
+uint32_t DataFlowWorklist::getNumberOfBasicBlocks (void) const {
+  return this->order.size();
+}
+
+uint32_t DataFlowWorklist::getPriority (BasicBlock *bb) const {
+  assert(this->priorities.find(bb) != this->priorities.end());
+
+  return this->priorities.at(bb);
+}
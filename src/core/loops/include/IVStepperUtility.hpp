@@ -33,6 +33,28 @@ namespace llvm {
         Value *chunkStepSize
       ) ;
 
+      /*
+       * Like the one above, but the step to the next chunk is computed for every latch by @computeChunkStepSize.
+       */
+      static void chunkInductionVariablePHI (
+        BasicBlock *preheaderBlock,
+        PHINode *ivPHI,
+        PHINode *chunkPHI,
+        std::function<Value * (BasicBlock *latch, IRBuilder<> &latchBuilder)> computeChunkStepSize
+      ) ;
+
+      /*
+       * Create a PHI that tracks the index of the chunk that is currently executed.
+       * The index starts from @firstChunkIndex and it is updated in every latch by @fetchNextChunkIndex.
+       */
+      static PHINode *createChunkIndexPHI (
+        BasicBlock *preheaderBlock,
+        BasicBlock *headerBlock,
+        PHINode *chunkPHI,
+        Value *firstChunkIndex,
+        std::function<Value * (IRBuilder<> &latchBuilder, Value *currentChunkIndex, Value *isChunkCompleted)> fetchNextChunkIndex
+      ) ;
+
       static Value *offsetIVPHI (
         BasicBlock *insertBlock,
         PHINode *ivPHI,
@@ -13,6 +13,7 @@
 #include "SystemHeaders.hpp"
 
 #include "PDG.hpp"
+#include "AliasQueryCache.hpp"
 #include "SCCDAG.hpp"
 #include "LoopsSummary.hpp"
 #include "InductionVariables.hpp"
@@ -47,6 +48,7 @@ namespace llvm {
        * Parallelization options
        */
       uint32_t DOALLChunkSize;
+      DOALLSchedule DOALLChunkSchedule;
 
       /*
        * Constructors.
@@ -88,6 +90,18 @@ namespace llvm {
         bool enableLoopAwareDependenceAnalyses
       );
 
+      LoopDependenceInfo (
+        PDG *fG,
+        Loop *l,
+        DominatorSummary &DS,
+        ScalarEvolution &SE,
+        uint32_t maxCores,
+        std::unordered_set<LoopDependenceInfoOptimization> optimizations,
+        liberty::LoopAA *aa,
+        bool enableLoopAwareDependenceAnalyses,
+        AliasQueryCache *aliasQueryCache
+      );
+
       LoopDependenceInfo () = delete ;
 
       /*
@@ -230,7 +244,8 @@ namespace llvm {
         PDG *functionDG,
         DominatorSummary &DS,
         ScalarEvolution &SE,
-        liberty::LoopAA *loopAA
+        liberty::LoopAA *loopAA,
+        AliasQueryCache *aliasQueryCache
         ) ;
 
       uint64_t computeTripCounts (
@@ -38,12 +38,56 @@ PHINode *IVUtility::createChunkPHI (BasicBlock *preheaderB, BasicBlock *headerB,
   return chunkPHI;
 }
 
+PHINode *IVUtility::createChunkIndexPHI (
+  BasicBlock *preheaderB,
+  BasicBlock *headerB,
+  PHINode *chunkPHI,
+  Value *firstChunkIndex,
+  std::function<Value * (IRBuilder<> &latchBuilder, Value *currentChunkIndex, Value *isChunkCompleted)> fetchNextChunkIndex
+) {
+
+  std::vector<BasicBlock *> headerPreds(pred_begin(headerB), pred_end(headerB));
+  IRBuilder<> headerBuilder(headerB->getFirstNonPHIOrDbgOrLifetime());
+  auto chunkIndexPHI = headerBuilder.CreatePHI(firstChunkIndex->getType(), headerPreds.size(), "chunkIndex");
+
+  for (auto B : headerPreds) {
+    if (preheaderB == B) {
+      chunkIndexPHI->addIncoming(firstChunkIndex, B);
+      continue ;
+    }
+
+    /*
+     * Fetch the index of the next chunk once the current one is completed.
+     */
+    IRBuilder<> latchBuilder(B->getTerminator());
+    auto chunkIncomingIdx = chunkPHI->getBasicBlockIndex(B);
+    Value *isChunkCompleted = cast<SelectInst>(chunkPHI->getIncomingValue(chunkIncomingIdx))->getCondition();
+    auto nextChunkIndex = fetchNextChunkIndex(latchBuilder, chunkIndexPHI, isChunkCompleted);
+    chunkIndexPHI->addIncoming(nextChunkIndex, B);
+  }
+
+  return chunkIndexPHI;
+}
+
 void IVUtility::chunkInductionVariablePHI(
   BasicBlock *preheaderBlock,
   PHINode *ivPHI,
   PHINode *chunkPHI,
   Value *chunkStepSize
 ) {
+  chunkInductionVariablePHI(preheaderBlock, ivPHI, chunkPHI, [chunkStepSize](BasicBlock *latch, IRBuilder<> &latchBuilder) -> Value * {
+    return chunkStepSize;
+  });
+
+  return ;
+}
+
+void IVUtility::chunkInductionVariablePHI(
+  BasicBlock *preheaderBlock,
+  PHINode *ivPHI,
+  PHINode *chunkPHI,
+  std::function<Value * (BasicBlock *latch, IRBuilder<> &latchBuilder)> computeChunkStepSize
+) {
 
   for (auto i = 0; i < ivPHI->getNumIncomingValues(); ++i) {
     auto B = ivPHI->getIncomingBlock(i);
@@ -54,6 +98,7 @@ void IVUtility::chunkInductionVariablePHI(
     Value *isChunkCompleted = cast<SelectInst>(chunkPHI->getIncomingValue(chunkIncomingIdx))->getCondition();
 
     auto initialLatchValue = ivPHI->getIncomingValue(i);
+    auto chunkStepSize = computeChunkStepSize(B, latchBuilder);
     auto ivOffsetByChunk = offsetIVPHI(B, ivPHI, initialLatchValue, chunkStepSize);
 
     /*
@@ -13,13 +13,14 @@ void llvm::refinePDGWithLoopAwareMemDepAnalysis(
   LoopStructure *loopStructure,
   LoopCarriedDependencies &LCD,
   liberty::LoopAA *loopAA,
+  AliasQueryCache *aliasQueryCache,
   LoopIterationDomainSpaceAnalysis *LIDS
 ) {
 
   // TODO: add here other types of loopAware refinements of the PDG
 
   if (loopAA) {
-    refinePDGWithSCAF(loopDG, l, loopAA);
+    refinePDGWithSCAF(loopDG, l, loopAA, aliasQueryCache);
   }
 
   if (LIDS) {
@@ -28,7 +29,16 @@ void llvm::refinePDGWithLoopAwareMemDepAnalysis(
 
 }
 
-void llvm::refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA) {
+void llvm::refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA, AliasQueryCache *aliasQueryCache) {
+  // Queries to SCAF are answered by the cache when the same loop is analyzed
+  // again (e.g., every time its LoopDependenceInfo is rebuilt)
+  auto disprove = [aliasQueryCache, l](AliasQueryCache::QueryKind kind, Instruction *i, Instruction *j, uint8_t depTypes, std::function<uint8_t (void)> query) -> uint8_t {
+    if (aliasQueryCache == nullptr) {
+      return query();
+    }
+    return aliasQueryCache->disproveMemoryDependences(kind, i, j, depTypes, l, query);
+  };
+
   // Iterate over all the edges of the loop PDG and
   // collect memory deps to be queried.
   // For each pair of instructions with a memory dependence map it to
@@ -83,8 +93,10 @@ void llvm::refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA) {
 			}
 		}
 		// Try to disprove all the reported loop-carried deps
-    uint8_t disprovedLCDepTypes =
-        disproveLoopCarriedMemoryDep(i, j, depTypes, l, loopAA);
+    uint8_t disprovedLCDepTypes = disprove(
+        AliasQueryCache::SCAF_LOOP_CARRIED, i, j, depTypes, [&]() {
+          return disproveLoopCarriedMemoryDep(i, j, depTypes, l, loopAA);
+        });
 		// set LoopCarried bit for all the non-disproved LC edges
 		uint8_t lcDepTypes = depTypes - disprovedLCDepTypes;
 		for (uint8_t i = 0; i <= 2; ++i) {
@@ -98,8 +110,10 @@ void llvm::refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA) {
     // check if there is a intra-iteration dependence
     uint8_t disprovedIIDepTypes = 0;
     if (disprovedLCDepTypes) {
-      disprovedIIDepTypes = disproveIntraIterationMemoryDep(
-          i, j, disprovedLCDepTypes, l, loopAA);
+      disprovedIIDepTypes = disprove(
+          AliasQueryCache::SCAF_INTRA_ITERATION, i, j, disprovedLCDepTypes, [&]() {
+            return disproveIntraIterationMemoryDep(i, j, disprovedLCDepTypes, l, loopAA);
+          });
 
       // remove any edge that SCAF disproved both its loop-carried and
       // intra-iteration version
@@ -134,41 +148,28 @@ DataFlowResult *computeReachabilityFromInstructions (LoopStructure *loopStructur
    */
   auto dfa = DataFlowEngine{};
   auto computeGEN = [](Instruction *i, DataFlowResult *df) {
-    auto& gen = df->GEN(i);
-    gen.insert(i);
+    auto& gen = df->denseGEN(i);
+    gen.set(df->getUniverseIndex(i));
     return ;
   };
   auto computeKILL = [](Instruction *, DataFlowResult *) {
     return ;
   };
-  auto computeOUT = [loopHeader](std::set<Value *>& OUT, Instruction *succ, DataFlowResult *df) {
+  auto propagateFrom = [loopHeader](Instruction *succ) -> bool {
 
     /*
      * Check if the successor is the header.
      * In this case, we do not propagate the reachable instructions.
      * We do this because we are interested in understanding the reachability of instructions within a single iteration.
      */
-    auto succBB = succ->getParent();
     if (succ == &*loopHeader->begin()) {
-      return ;
+      return false;
     }
 
-    /*
-     * Propagate the data flow values.
-     */
-    auto& inS = df->IN(succ);
-    OUT.insert(inS.begin(), inS.end());
-    return ;
+    return true;
   } ;
-  auto computeIN = [](std::set<Value *>& IN, Instruction *inst, DataFlowResult *df) {
-    auto& genI = df->GEN(inst);
-    auto& outI = df->OUT(inst);
-    IN.insert(outI.begin(), outI.end());
-    IN.insert(genI.begin(), genI.end());
-    return ;
-  };
 
-  return dfa.applyBackward(loopFunction, computeGEN, computeKILL, computeIN, computeOUT);
+  return dfa.applyDenseBackward(loopFunction, computeGEN, computeKILL, propagateFrom);
 }
 
 void llvm::refinePDGWithLIDS(
@@ -208,8 +209,7 @@ void llvm::refinePDGWithLIDS(
      * remove dependencies between a producer and consumer where we know the producer
      * can NEVER reach the consumer during the same iteration
      */
-    auto &afterInstructions = dfr->OUT(fromInst);
-    if (afterInstructions.find(toInst) != afterInstructions.end()) continue;
+    if (dfr->doesOUTContain(fromInst, toInst)) continue;
 
     if (LIDS->areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(fromInst, toInst)) {
       edgesToRemove.insert(dependency);
@@ -5,6 +5,7 @@
 #include "SystemHeaders.hpp"
 
 #include "PDG.hpp"
+#include "AliasQueryCache.hpp"
 #include "scaf/MemoryAnalysisModules/LoopAA.h"
 #include "LoopCarriedDependencies.hpp"
 #include "LoopIterationDomainSpaceAnalysis.hpp"
@@ -19,11 +20,13 @@ void refinePDGWithLoopAwareMemDepAnalysis(
   LoopStructure *loopStructure,
   LoopCarriedDependencies &LCD,
   liberty::LoopAA *loopAA,
+  AliasQueryCache *aliasQueryCache,
   LoopIterationDomainSpaceAnalysis *LIDS
 );
 
 // Refine the loop PDG with SCAF
-void refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA);
+// Results of SCAF are memoized in aliasQueryCache when it is not null
+void refinePDGWithSCAF(PDG *loopDG, Loop *l, liberty::LoopAA *loopAA, AliasQueryCache *aliasQueryCache);
 
 void refinePDGWithLIDS(
   PDG *loopDG,
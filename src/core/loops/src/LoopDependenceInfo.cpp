@@ -60,7 +60,23 @@ LoopDependenceInfo::LoopDependenceInfo(
   std::unordered_set<LoopDependenceInfoOptimization> optimizations,
   liberty::LoopAA *loopAA,
   bool enableLoopAwareDependenceAnalyses
+) : LoopDependenceInfo{fG, l, DS, SE, maxCores, optimizations, loopAA, enableLoopAwareDependenceAnalyses, nullptr} {
+
+  return ;
+}
+
+LoopDependenceInfo::LoopDependenceInfo(
+  PDG *fG,
+  Loop *l,
+  DominatorSummary &DS,
+  ScalarEvolution &SE,
+  uint32_t maxCores,
+  std::unordered_set<LoopDependenceInfoOptimization> optimizations,
+  liberty::LoopAA *loopAA,
+  bool enableLoopAwareDependenceAnalyses,
+  AliasQueryCache *aliasQueryCache
 ) : DOALLChunkSize{8},
+    DOALLChunkSchedule{DOALL_STATIC_SCHEDULE},
     maximumNumberOfCoresForTheParallelization{maxCores},
     liSummary{l},
     enabledOptimizations{optimizations},
@@ -78,7 +94,7 @@ LoopDependenceInfo::LoopDependenceInfo(
   this->fetchLoopAndBBInfo(l, SE);
   auto ls = this->getLoopStructure();
   auto loopExitBlocks = ls->getLoopExitBasicBlocks();
-  auto DGs = this->createDGsForLoop(l, fG, DS, SE, loopAA);
+  auto DGs = this->createDGsForLoop(l, fG, DS, SE, loopAA, aliasQueryCache);
   this->loopDG = DGs.first;
   auto loopSCCDAG = DGs.second;
 
@@ -120,6 +136,7 @@ LoopDependenceInfo::LoopDependenceInfo(
 
 void LoopDependenceInfo::copyParallelizationOptionsFrom (LoopDependenceInfo *otherLDI) {
   this->DOALLChunkSize = otherLDI->DOALLChunkSize;
+  this->DOALLChunkSchedule = otherLDI->DOALLChunkSchedule;
   this->enabledTransformations = otherLDI->enabledTransformations;
   this->maximumNumberOfCoresForTheParallelization = otherLDI->maximumNumberOfCoresForTheParallelization;
   this->areLoopAwareAnalysesEnabled = otherLDI->areLoopAwareAnalysesEnabled;
@@ -172,7 +189,8 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop (
   PDG *functionDG,
   DominatorSummary &DS,
   ScalarEvolution &SE,
-  liberty::LoopAA *aa
+  liberty::LoopAA *aa,
+  AliasQueryCache *aliasQueryCache
 ) {
 
   /*
@@ -209,7 +227,7 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop (
   auto ivManager = InductionVariableManager(liSummary, invManager, SE, preRefinedSCCDAG, env);
   auto domainSpace = LoopIterationDomainSpaceAnalysis(liSummary, ivManager, SE);
   if (this->areLoopAwareAnalysesEnabled){
-    refinePDGWithLoopAwareMemDepAnalysis(loopDG, l, loopStructure, lcdUsingLoopDGEdges, aa, &domainSpace);
+    refinePDGWithLoopAwareMemDepAnalysis(loopDG, l, loopStructure, lcdUsingLoopDGEdges, aa, aliasQueryCache, &domainSpace);
   }
 
   if (enabledOptimizations.find(LoopDependenceInfoOptimization::MEMORY_CLONING_ID) != enabledOptimizations.end()) {
@@ -47,6 +47,13 @@ namespace llvm::noelle {
 
       bool runOnModule (Module &M) override ;
 
+      void releaseMemory (void) override ;
+
+      /*
+       * Loop dependence infos are owned by NOELLE, so clients must not free them.
+       * Each of them is built once and it is returned again to later requests of the same loop with the same options.
+       * This lasts until the loops of its function are invalidated (see invalidateLoops).
+       */
       std::vector<LoopDependenceInfo *> * getLoops (void) ;
 
       std::vector<LoopDependenceInfo *> * getLoops (
@@ -128,6 +135,27 @@ namespace llvm::noelle {
 
       PDG * getFunctionDependenceGraph (Function *f) ;
 
+      /*
+       * Notify NOELLE that a transformation has modified the function @f.
+       * Only the dependences of @f are recomputed, and this happens the next time they are requested.
+       * The loops of @f are invalidated as well.
+       */
+      void invalidateFunctionDependences (Function *f) ;
+
+      /*
+       * Notify NOELLE that a transformation has modified the loops of the function @f.
+       * The loop dependence infos of @f returned so far are freed, and new ones are built the next time they are requested.
+       */
+      void invalidateLoops (Function *f) ;
+
+      /*
+       * Normalize the functions @functions as noelle-norm does, after a transformation has modified them.
+       * Their dependences are invalidated.
+       */
+      void normalizeFunctions (std::unordered_set<Function *> const &functions) ;
+
+      uint64_t getNumberOfLoopDependenceInfosBuilt (void) const ;
+
       DataFlowAnalysis getDataFlowAnalyses (void) const ;
 
       DataFlowEngine getDataFlowEngine (void) const ;
@@ -200,8 +228,28 @@ namespace llvm::noelle {
       std::vector<uint32_t> loopThreads;
       std::vector<uint32_t> techniquesToDisable;
       std::vector<uint32_t> DOALLChunkSize;
+      std::vector<uint32_t> DOALLChunkSchedule;
       std::unordered_map<BasicBlock *, uint32_t> loopHeaderToLoopIndexMap;
 
+      /*
+       * Options a loop dependence info has been built with.
+       */
+      struct LoopDependenceInfoKey {
+        BasicBlock *header;
+        std::set<LoopDependenceInfoOptimization> optimizations;
+        bool isConfiguredByIndexFile;   /* The fields below have been set by INDEX_FILE. */
+        uint32_t techniquesToDisable;
+        uint32_t DOALLChunkSize;
+        uint32_t DOALLChunkSchedule;
+        uint32_t maxCores;
+
+        bool operator< (LoopDependenceInfoKey const &other) const ;
+      };
+
+      std::unordered_map<Function *, std::map<LoopDependenceInfoKey, LoopDependenceInfo *>> loopDependenceInfos;
+      uint64_t numberOfLoopDependenceInfosBuilt;
+      uint64_t numberOfLoopDependenceInfosReused;
+
       uint32_t fetchTheNextValue (
         std::stringstream &stream
         );
@@ -215,9 +263,33 @@ namespace llvm::noelle {
         ScalarEvolution *SE,
         uint32_t techniquesToDisable,
         uint32_t DOALLChunkSize,
+        uint32_t DOALLChunkSchedule,
         uint32_t maxCores
       );
 
+      LoopDependenceInfoKey getLoopDependenceInfoKey (
+        BasicBlock *header,
+        std::unordered_set<LoopDependenceInfoOptimization> const &optimizations
+      ) const ;
+
+      LoopDependenceInfoKey getLoopDependenceInfoKey (
+        BasicBlock *header,
+        uint32_t loopIndex,
+        uint32_t maxCores
+      ) const ;
+
+      LoopDependenceInfo * fetchLoopDependenceInfo (
+        LoopDependenceInfoKey const &key
+      );
+
+      LoopDependenceInfo * buildLoopDependenceInfo (
+        Loop *loop,
+        PDG *functionPDG,
+        DominatorSummary *DS,
+        ScalarEvolution *SE,
+        LoopDependenceInfoKey const &key
+      );
+
       bool isLoopHot (LoopStructure *loopStructure, double minimumHotness) ;
       bool isFunctionHot (Function *function, double minimumHotness) ;
 
@@ -25,6 +25,8 @@ Noelle::Noelle()
   , hoistLoopsToMain{false}
   , loopAwareDependenceAnalysis{false}
   , pcg{nullptr}
+  , numberOfLoopDependenceInfosBuilt{0}
+  , numberOfLoopDependenceInfosReused{0}
 {
 
   return ;
@@ -290,6 +292,15 @@ noelle::CallGraph * Noelle::getProgramCallGraph (void) {
 
 Noelle::~Noelle(){
 
+  /*
+   * Report how many loop dependence infos have been built during the whole compilation.
+   */
+  if (this->verbose >= Verbosity::Minimal){
+    errs() << "Noelle: Loop dependence infos built = " << this->numberOfLoopDependenceInfosBuilt << " (requests served by reusing them = " << this->numberOfLoopDependenceInfosReused << ")\n";
+  }
+
+  this->releaseMemory();
+
   return ;
 }
 
@@ -13,9 +13,11 @@
 namespace llvm::noelle{
 
 PDG * Noelle::getProgramDependenceGraph (void) {
-  if (this->programDependenceGraph == nullptr){
-    this->programDependenceGraph = this->pdgAnalysis->getPDG();
-  }
+
+  /*
+   * The PDG analysis returns the PDG it has already computed after updating the dependences of the functions that have been invalidated.
+   */
+  this->programDependenceGraph = this->pdgAnalysis->getPDG();
 
   return this->programDependenceGraph;
 }
@@ -24,4 +26,15 @@ PDG * Noelle::getFunctionDependenceGraph (Function *f) {
   return this->pdgAnalysis->getFunctionPDG(*f);
 }
 
+void Noelle::invalidateFunctionDependences (Function *f) {
+  this->pdgAnalysis->invalidateFunction(*f);
+
+  /*
+   * Loop dependence infos include the dependences of their loops.
+   */
+  this->invalidateLoops(f);
+
+  return ;
+}
+
 }
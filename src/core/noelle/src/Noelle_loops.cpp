@@ -192,69 +192,71 @@ LoopDependenceInfo * Noelle::getLoop (
     LoopStructure *loop,
     std::unordered_set<LoopDependenceInfoOptimization> optimizations
     ) {
-
-  /*
-   * Fetch the the function dependence graph, post dominators, and scalar evolution
-   */
   auto header = loop->getHeader();
   auto function = header->getParent();
-  auto funcPDG = this->getFunctionDependenceGraph(function);
-  auto DS = this->getDominators(function);
 
   /*
-   * Fetch the llvm loop corresponding to the loop structure
+   * Compute the options of the loop dependence info.
    */
-  auto& LI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
-  auto& SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
-  auto llvmLoop = LI.getLoopFor(header);
+  LoopDependenceInfoKey key;
+  if (this->loopHeaderToLoopIndexMap.find(header) == this->loopHeaderToLoopIndexMap.end()){
+    key = this->getLoopDependenceInfoKey(header, {});
+
+  } else if (!this->hasReadFilterFile) {
+
+    /*
+     * No filter file was provided. Construct LDI without profiler configurables
+     */
+    key = this->getLoopDependenceInfoKey(header, optimizations);
+
+  } else {
+
+    /*
+     * Fetch the loop index.
+     */
+    auto loopIndex = this->loopHeaderToLoopIndexMap.at(header);
+
+    /*
+     * Ensure loop configurables exist for this loop index
+     */
+    if (loopIndex >= this->loopThreads.size()){
+      errs() << "ERROR: the 'INDEX_FILE' file isn't correct. There are more than " << this->loopThreads.size()
+        << " loops available in the program\n";
+      abort();
+    }
+
+    auto maximumNumberOfCoresForTheParallelization = this->loopThreads[loopIndex];
+    assert(maximumNumberOfCoresForTheParallelization > 1
+        && "Noelle: passed user a filtered loop yet it only has max cores <= 1");
+
+    key = this->getLoopDependenceInfoKey(header, loopIndex, maximumNumberOfCoresForTheParallelization);
+  }
 
   /*
-   * Check of loopIndex provided is within bounds
+   * Check if the loop dependence info has been built already.
    */
-  if (this->loopHeaderToLoopIndexMap.find(header) == this->loopHeaderToLoopIndexMap.end()){
-    auto ldi = new LoopDependenceInfo(funcPDG, llvmLoop, *DS, SE, this->maxCores, {}, this->loopAA, this->loopAwareDependenceAnalysis);
-
-    delete DS;
+  auto ldi = this->fetchLoopDependenceInfo(key);
+  if (ldi != nullptr){
     return ldi;
   }
 
   /*
-   * Fetch the loop index.
+   * Fetch the the function dependence graph, post dominators, and scalar evolution
    */
-  auto loopIndex = this->loopHeaderToLoopIndexMap.at(header);
+  auto funcPDG = this->getFunctionDependenceGraph(function);
+  auto DS = this->getDominators(function);
 
   /*
-   * No filter file was provided. Construct LDI without profiler configurables
+   * Fetch the llvm loop corresponding to the loop structure
    */
-  if (!this->hasReadFilterFile) {
-    auto ldi = new LoopDependenceInfo(funcPDG, llvmLoop, *DS, SE, this->maxCores, optimizations, this->loopAA, this->loopAwareDependenceAnalysis);
-
-    delete DS;
-    return ldi;
-  }
+  auto& LI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
+  auto& SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
+  auto llvmLoop = LI.getLoopFor(header);
 
   /*
-   * Ensure loop configurables exist for this loop index
+   * Build the loop dependence info.
    */
-  if (loopIndex >= this->loopThreads.size()){
-    errs() << "ERROR: the 'INDEX_FILE' file isn't correct. There are more than " << this->loopThreads.size()
-      << " loops available in the program\n";
-    abort();
-  }
-
-  auto maximumNumberOfCoresForTheParallelization = this->loopThreads[loopIndex];
-  assert(maximumNumberOfCoresForTheParallelization > 1
-      && "Noelle: passed user a filtered loop yet it only has max cores <= 1");
-
-  auto ldi = getLoopDependenceInfoForLoop(
-      llvmLoop,
-      funcPDG,
-      DS,
-      &SE,
-      this->techniquesToDisable[loopIndex],
-      this->DOALLChunkSize[loopIndex],
-      maximumNumberOfCoresForTheParallelization
-      );
+  ldi = this->buildLoopDependenceInfo(llvmLoop, funcPDG, DS, &SE, key);
 
   delete DS;
   return ldi;
@@ -335,9 +337,13 @@ std::vector<LoopDependenceInfo *> * Noelle::getLoops (
     }
 
     /*
-     * Allocate the loop wrapper.
+     * Fetch the loop wrapper.
      */
-    auto ldi = new LoopDependenceInfo(funcPDG, loop, *DS, SE, this->maxCores, {}, this->loopAA, this->loopAwareDependenceAnalysis);
+    auto key = this->getLoopDependenceInfoKey(loop->getHeader(), {});
+    auto ldi = this->fetchLoopDependenceInfo(key);
+    if (ldi == nullptr){
+      ldi = this->buildLoopDependenceInfo(loop, funcPDG, DS, &SE, key);
+    }
     allLoops->push_back(ldi);
   }
 
@@ -450,9 +456,13 @@ std::vector<LoopDependenceInfo *> * Noelle::getLoops (
       if (!filterLoops){
 
         /*
-         * Allocate the loop wrapper.
+         * Fetch the loop wrapper.
          */
-        auto ldi = new LoopDependenceInfo(funcPDG, loop, *DS, SE, this->maxCores, {}, this->loopAA, this->loopAwareDependenceAnalysis);
+        auto key = this->getLoopDependenceInfoKey(loop->getHeader(), {});
+        auto ldi = this->fetchLoopDependenceInfo(key);
+        if (ldi == nullptr){
+          ldi = this->buildLoopDependenceInfo(loop, funcPDG, DS, &SE, key);
+        }
 
         allLoops->push_back(ldi);
         continue ;
@@ -484,15 +494,11 @@ std::vector<LoopDependenceInfo *> * Noelle::getLoops (
         abort();
       }
 
-      auto ldi = getLoopDependenceInfoForLoop(
-          loop,
-          funcPDG,
-          DS,
-          &SE,
-          this->techniquesToDisable[currentLoopIndex],
-          this->DOALLChunkSize[currentLoopIndex],
-          maximumNumberOfCoresForTheParallelization
-          );
+      auto key = this->getLoopDependenceInfoKey(loop->getHeader(), currentLoopIndex, maximumNumberOfCoresForTheParallelization);
+      auto ldi = this->fetchLoopDependenceInfo(key);
+      if (ldi == nullptr){
+        ldi = this->buildLoopDependenceInfo(loop, funcPDG, DS, &SE, key);
+      }
 
       /*
        * The current loop needs to be considered as specified by the user.
@@ -704,12 +710,25 @@ bool Noelle::checkToGetLoopFilteringInfo (void) {
      */
     auto DOALLChunkFactor = this->fetchTheNextValue(indexString);
 
+    /*
+     * DOALL: schedule of the chunks
+     * 0: Static
+     * 1: Dynamic
+     * 2: Guided
+     *
+     * This field was ignored before schedules were introduced: files written for older versions must set it to 0 to keep the static schedule.
+     */
+    auto DOALLChunkScheduleOfLoop = this->fetchTheNextValue(indexString);
+    if (DOALLChunkScheduleOfLoop > DOALL_GUIDED_SCHEDULE){
+      errs() << "ERROR: the 'INDEX_FILE' file isn't correct. The DOALL schedule (7th field) of the loop " << this->loopThreads.size() << " is " << DOALLChunkScheduleOfLoop << ", but it must be 0 (static), 1 (dynamic), or 2 (guided)\n";
+      abort();
+    }
+
     /*
      * Skip
      */
     this->fetchTheNextValue(indexString);
     this->fetchTheNextValue(indexString);
-    this->fetchTheNextValue(indexString);
 
     /*
      * If the loop needs to be parallelized, then we enable it.
@@ -719,11 +738,13 @@ bool Noelle::checkToGetLoopFilteringInfo (void) {
       this->loopThreads.push_back(cores);
       this->techniquesToDisable.push_back(technique);
       this->DOALLChunkSize.push_back(DOALLChunkFactor);
+      this->DOALLChunkSchedule.push_back(DOALLChunkScheduleOfLoop);
 
     } else{
       this->loopThreads.push_back(1);
       this->techniquesToDisable.push_back(0);
       this->DOALLChunkSize.push_back(0);
+      this->DOALLChunkSchedule.push_back(DOALL_STATIC_SCHEDULE);
     }
   }
 
@@ -812,10 +833,11 @@ LoopDependenceInfo * Noelle::getLoopDependenceInfoForLoop (
     ScalarEvolution *SE,
     uint32_t techniquesToDisableForLoop,
     uint32_t DOALLChunkSizeForLoop,
+    uint32_t DOALLChunkScheduleForLoop,
     uint32_t maxCores
     ) {
 
-  auto ldi = new LoopDependenceInfo(functionPDG, loop, *DS, *SE, maxCores, {}, this->loopAA, this->loopAwareDependenceAnalysis);
+  auto ldi = new LoopDependenceInfo(functionPDG, loop, *DS, *SE, maxCores, {}, this->loopAA, this->loopAwareDependenceAnalysis, this->pdgAnalysis->getAliasQueryCache());
 
   /*
    * Set the loop constraints specified by INDEX_FILE.
@@ -823,6 +845,7 @@ LoopDependenceInfo * Noelle::getLoopDependenceInfoForLoop (
    * DOALL chunk size is the one defined by INDEX_FILE + 1. This is because chunk size must start from 1.
    */
   ldi->DOALLChunkSize = DOALLChunkSizeForLoop + 1;
+  ldi->DOALLChunkSchedule = static_cast<DOALLSchedule>(DOALLChunkScheduleForLoop);
 
   /*
    * Set the techniques that are enabled.
@@ -868,6 +891,130 @@ LoopDependenceInfo * Noelle::getLoopDependenceInfoForLoop (
   return ldi;
 }
 
+Noelle::LoopDependenceInfoKey Noelle::getLoopDependenceInfoKey (
+    BasicBlock *header,
+    std::unordered_set<LoopDependenceInfoOptimization> const &optimizations
+    ) const {
+  LoopDependenceInfoKey key;
+  key.header = header;
+  key.optimizations.insert(optimizations.begin(), optimizations.end());
+  key.isConfiguredByIndexFile = false;
+  key.techniquesToDisable = 0;
+  key.DOALLChunkSize = 0;
+  key.DOALLChunkSchedule = 0;
+  key.maxCores = this->maxCores;
+
+  return key;
+}
+
+Noelle::LoopDependenceInfoKey Noelle::getLoopDependenceInfoKey (
+    BasicBlock *header,
+    uint32_t loopIndex,
+    uint32_t maxCores
+    ) const {
+  LoopDependenceInfoKey key;
+  key.header = header;
+  key.isConfiguredByIndexFile = true;
+  key.techniquesToDisable = this->techniquesToDisable[loopIndex];
+  key.DOALLChunkSize = this->DOALLChunkSize[loopIndex];
+  key.DOALLChunkSchedule = this->DOALLChunkSchedule[loopIndex];
+  key.maxCores = maxCores;
+
+  return key;
+}
+
+LoopDependenceInfo * Noelle::fetchLoopDependenceInfo (
+    LoopDependenceInfoKey const &key
+    ) {
+
+  /*
+   * Fetch the loop dependence infos of the function that includes the loop.
+   */
+  auto function = key.header->getParent();
+  auto functionIt = this->loopDependenceInfos.find(function);
+  if (functionIt == this->loopDependenceInfos.end()){
+    return nullptr;
+  }
+
+  /*
+   * Check if the loop has already been requested with the same options.
+   */
+  auto &ldis = functionIt->second;
+  auto ldiIt = ldis.find(key);
+  if (ldiIt == ldis.end()){
+    return nullptr;
+  }
+  this->numberOfLoopDependenceInfosReused++;
+
+  return ldiIt->second;
+}
+
+LoopDependenceInfo * Noelle::buildLoopDependenceInfo (
+    Loop *loop,
+    PDG *functionPDG,
+    DominatorSummary *DS,
+    ScalarEvolution *SE,
+    LoopDependenceInfoKey const &key
+    ) {
+  assert(loop->getHeader() == key.header);
+
+  /*
+   * Build the loop dependence info.
+   */
+  LoopDependenceInfo *ldi = nullptr;
+  if (key.isConfiguredByIndexFile){
+    ldi = this->getLoopDependenceInfoForLoop(
+        loop,
+        functionPDG,
+        DS,
+        SE,
+        key.techniquesToDisable,
+        key.DOALLChunkSize,
+        key.DOALLChunkSchedule,
+        key.maxCores
+        );
+
+  } else {
+    std::unordered_set<LoopDependenceInfoOptimization> optimizations(key.optimizations.begin(), key.optimizations.end());
+    ldi = new LoopDependenceInfo(functionPDG, loop, *DS, *SE, key.maxCores, optimizations, this->loopAA, this->loopAwareDependenceAnalysis, this->pdgAnalysis->getAliasQueryCache());
+  }
+
+  /*
+   * Keep the loop dependence info for later requests.
+   */
+  auto function = key.header->getParent();
+  this->loopDependenceInfos[function][key] = ldi;
+  this->numberOfLoopDependenceInfosBuilt++;
+
+  return ldi;
+}
+
+void Noelle::invalidateLoops (Function *f) {
+
+  /*
+   * Free the loop dependence infos of @f.
+   */
+  auto functionIt = this->loopDependenceInfos.find(f);
+  if (functionIt == this->loopDependenceInfos.end()){
+    return ;
+  }
+  for (auto &keyAndLDI : functionIt->second){
+    delete keyAndLDI.second;
+  }
+  this->loopDependenceInfos.erase(functionIt);
+
+  return ;
+}
+
+uint64_t Noelle::getNumberOfLoopDependenceInfosBuilt (void) const {
+  return this->numberOfLoopDependenceInfosBuilt;
+}
+
+bool Noelle::LoopDependenceInfoKey::operator< (LoopDependenceInfoKey const &other) const {
+  return std::tie(this->header, this->optimizations, this->isConfiguredByIndexFile, this->techniquesToDisable, this->DOALLChunkSize, this->DOALLChunkSchedule, this->maxCores)
+    < std::tie(other.header, other.optimizations, other.isConfiguredByIndexFile, other.techniquesToDisable, other.DOALLChunkSize, other.DOALLChunkSchedule, other.maxCores);
+}
+
 bool Noelle::isLoopHot (LoopStructure *loopStructure, double minimumHotness) {
   if (!profiles->isAvailable()) {
     return true;
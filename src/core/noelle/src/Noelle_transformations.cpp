@@ -9,6 +9,9 @@
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "SystemHeaders.hpp"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils.h"
+#include "llvm/Transforms/Utils/UnifyFunctionExitNodes.h"
 
 #include "Noelle.hpp"
 
@@ -20,4 +23,38 @@ bool Noelle::isTransformationEnabled (Transformation transformation){
   return exist;
 }
 
+void Noelle::normalizeFunctions (std::unordered_set<Function *> const &functions){
+
+  /*
+   * Create the normalization passes of noelle-norm.
+   *
+   * Breaking constant GEPs is skipped: it is a module pass and transformations do not introduce constant expressions.
+   */
+  legacy::FunctionPassManager normalization(this->program);
+  normalization.add(createPromoteMemoryToRegisterPass());
+  normalization.add(createCFGSimplificationPass(1, false, false, true, /*SinkCommon=*/ false));
+  normalization.add(createLowerSwitchPass());
+  normalization.add(createUnifyFunctionExitNodesPass());
+  normalization.add(createBreakCriticalEdgesPass());
+  normalization.add(createLoopSimplifyPass());
+  normalization.add(createLCSSAPass());
+  normalization.add(createIndVarSimplifyPass());
+
+  /*
+   * Normalize the functions.
+   */
+  normalization.doInitialization();
+  for (auto f : functions){
+    normalization.run(*f);
+
+    /*
+     * The dependences of the function have changed.
+     */
+    this->invalidateFunctionDependences(f);
+  }
+  normalization.doFinalization();
+
+  return ;
+}
+
 }
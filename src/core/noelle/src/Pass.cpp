@@ -115,6 +115,21 @@ bool Noelle::runOnModule (Module &M){
   return false;
 }
 
+void Noelle::releaseMemory (void) {
+
+  /*
+   * Free the loop dependence infos.
+   */
+  for (auto &functionLoops : this->loopDependenceInfos){
+    for (auto &keyAndLDI : functionLoops.second){
+      delete keyAndLDI.second;
+    }
+  }
+  this->loopDependenceInfos.clear();
+
+  return ;
+}
+
 // Next there is code to register your pass to "opt"
 char Noelle::ID = 0;
 static RegisterPass<Noelle> X("parallelization", "Computing the Program Dependence Graph");
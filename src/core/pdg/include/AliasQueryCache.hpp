@@ -0,0 +1,128 @@
+/*
+ * Copyright 2016 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/ValueHandle.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/MemoryLocation.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Support/raw_ostream.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace llvm {
+
+  /*
+   * Memoization of the results of alias analysis queries.
+   *
+   * A query is identified by its kind and by the exact operands given to the alias analysis (pointers, sizes, AA metadata, call sites, and loops).
+   * Hence, the cache is valid only for a single snapshot of the IR: it must be cleared whenever the IR is modified.
+   * Adding instructions or changing operands is not detected, so PDGAnalysis clears the cache when it rebuilds the PDG or when a function is invalidated.
+   * The whole cache is also dropped as soon as one of the cached values is deleted.
+   */
+  class AliasQueryCache {
+    public:
+
+      enum QueryKind : uint8_t {
+        LLVM_ALIAS,
+        SVF_ALIAS,
+        LLVM_MODREF,
+        SVF_MODREF,
+        SCAF_LOOP_CARRIED,
+        SCAF_INTRA_ITERATION,
+        NUMBER_OF_QUERY_KINDS
+      };
+
+      AliasQueryCache ();
+
+      /*
+       * Alias queries are symmetric, so the two locations can be given in any order.
+       */
+      AliasResult alias (
+        QueryKind kind,
+        const MemoryLocation &location1,
+        const MemoryLocation &location2,
+        std::function<AliasResult (void)> query
+        );
+
+      ModRefInfo getModRefInfo (
+        QueryKind kind,
+        const CallInst *call,
+        const MemoryLocation &location,
+        std::function<ModRefInfo (void)> query
+        );
+
+      ModRefInfo getModRefInfo (
+        QueryKind kind,
+        const CallInst *call,
+        const CallInst *otherCall,
+        std::function<ModRefInfo (void)> query
+        );
+
+      /*
+       * Memoize the set of dependence types (RAW, WAW, WAR bits) between @from and @to that a loop-aware analysis disproved within @loop.
+       */
+      uint8_t disproveMemoryDependences (
+        QueryKind kind,
+        const Instruction *from,
+        const Instruction *to,
+        uint8_t dependenceTypes,
+        const Loop *loop,
+        std::function<uint8_t (void)> query
+        );
+
+      void clear (void);
+
+      uint64_t getNumberOfHits (QueryKind kind) const ;
+
+      uint64_t getNumberOfMisses (QueryKind kind) const ;
+
+      raw_ostream & printStatistics (raw_ostream &stream) const ;
+
+      ~AliasQueryCache ();
+
+    private:
+      using QueryKey = std::array<uintptr_t, 11>;
+
+      struct QueryKeyHash {
+        size_t operator() (const QueryKey &key) const ;
+      };
+
+      class DeletionHandle : public CallbackVH {
+        public:
+          DeletionHandle (Value *value, AliasQueryCache *cache);
+
+          void deleted (void) override ;
+
+        private:
+          AliasQueryCache *cache;
+      };
+
+      std::unordered_map<QueryKey, uint8_t, QueryKeyHash> results;
+      std::unordered_map<const Value *, std::unique_ptr<DeletionHandle>> trackedValues;
+      std::array<uint64_t, NUMBER_OF_QUERY_KINDS> hits;
+      std::array<uint64_t, NUMBER_OF_QUERY_KINDS> misses;
+
+      uint8_t lookup (
+        QueryKey const &key,
+        QueryKind kind,
+        std::function<uint8_t (void)> query
+        );
+
+      void track (const Value *value);
+
+      void fillLocation (QueryKey &key, uint32_t index, const MemoryLocation &location);
+  };
+
+}
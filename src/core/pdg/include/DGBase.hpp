@@ -17,6 +17,8 @@
 #include <queue>
 #include <set>
 #include <optional>
+#include <memory>
+#include <type_traits>
 
 #include "Assumptions.h"
 
@@ -34,16 +36,103 @@ namespace llvm {
 
   enum DataDependenceType { DG_DATA_NONE, DG_DATA_RAW, DG_DATA_WAR, DG_DATA_WAW };
 
+  /*
+   * Slab allocator for the nodes and the edges of a graph.
+   *
+   * Objects are carved out of chunks that grow geometrically, so small graphs (e.g., SCCs) stay small.
+   * Slots of released objects are recycled; chunks are returned to the system only by reset or destruction.
+   */
+  template <class X>
+  class DGArena {
+    public:
+      DGArena () : currentChunkSize{0}, nextSlot{0}, nextChunkSize{MinimumChunkSize} {}
+
+      DGArena (const DGArena<X> &) = delete;
+      DGArena<X> & operator= (const DGArena<X> &) = delete;
+
+      void * allocate (void) {
+
+        /*
+         * Recycle a released slot if there is one.
+         */
+        if (!freeSlots.empty()){
+          auto slot = freeSlots.back();
+          freeSlots.pop_back();
+          return slot;
+        }
+
+        /*
+         * Allocate a new chunk if the current one is full.
+         */
+        if (nextSlot == currentChunkSize){
+          chunks.emplace_back(new Slot[nextChunkSize]);
+          currentChunkSize = nextChunkSize;
+          nextSlot = 0;
+          nextChunkSize = std::min(nextChunkSize * 2, MaximumChunkSize);
+        }
+
+        return &(chunks.back()[nextSlot++]);
+      }
+
+      void release (X *object) {
+        object->~X();
+        freeSlots.push_back(object);
+      }
+
+      /*
+       * Number of bytes of the chunks currently held by this arena.
+       */
+      uint64_t getNumberOfBytesAllocated (void) const {
+        uint64_t bytes = 0;
+        for (auto chunkSize = MinimumChunkSize, i = 0u; i < chunks.size(); i++){
+          bytes += chunkSize * sizeof(Slot);
+          chunkSize = std::min(chunkSize * 2, MaximumChunkSize);
+        }
+        return bytes;
+      }
+
+      /*
+       * Free all chunks.
+       * All objects allocated from this arena must have been destroyed already.
+       */
+      void reset (void) {
+        chunks.clear();
+        freeSlots.clear();
+        currentChunkSize = 0;
+        nextSlot = 0;
+        nextChunkSize = MinimumChunkSize;
+      }
+
+    private:
+      typedef typename std::aligned_storage<sizeof(X), alignof(X)>::type Slot;
+      static constexpr uint32_t MinimumChunkSize = 16;
+      static constexpr uint32_t MaximumChunkSize = 4096;
+
+      std::vector<std::unique_ptr<Slot[]>> chunks;
+      std::vector<void *> freeSlots;
+      uint32_t currentChunkSize;
+      uint32_t nextSlot;
+      uint32_t nextChunkSize;
+  };
+
   template <class T>
   class DG {
     public:
-      DG () : nodeIdCounter{0} {}
+      DG () : nodeIdCounter{0}, entryNode{nullptr} {}
+
+      DG (const DG<T> &) = delete;
+      DG<T> & operator= (const DG<T> &) = delete;
+
+      /*
+       * Nodes and edges are owned by the graph: they are destroyed with it.
+       */
+      ~DG () ;
 
-      typedef typename std::unordered_set<DGNode<T> *>::iterator nodes_iterator;
-      typedef typename std::unordered_set<DGNode<T> *>::const_iterator nodes_const_iterator;
+      typedef typename std::vector<DGNode<T> *>::iterator nodes_iterator;
+      typedef typename std::vector<DGNode<T> *>::const_iterator nodes_const_iterator;
 
-      typedef typename std::unordered_set<DGEdge<T> *>::iterator edges_iterator;
-      typedef typename std::unordered_set<DGEdge<T> *>::const_iterator edges_const_iterator;
+      typedef typename std::vector<DGEdge<T> *>::iterator edges_iterator;
+      typedef typename std::vector<DGEdge<T> *>::const_iterator edges_const_iterator;
 
       typedef typename unordered_map<T *, DGNode<T> *>::iterator node_map_iterator;
 
@@ -125,6 +214,12 @@ namespace llvm {
       unsigned numExternalNodes() const { return externalNodeMap.size(); }
       unsigned numEdges() const { return allEdges.size(); }
 
+      /*
+       * Approximate number of bytes used by the graph: its nodes, its edges, their adjacency lists, and the maps from T to nodes.
+       * The values of type T are not included.
+       */
+      uint64_t getMemoryFootprint() const;
+
       /*
        * Iterator ranges
        */
@@ -167,11 +262,22 @@ namespace llvm {
 
     protected:
       int32_t nodeIdCounter;
-      std::unordered_set<DGNode<T> *> allNodes;
-      std::unordered_set<DGEdge<T> *> allEdges;
+
+      /*
+       * Nodes and edges are kept densely: the position of each one within these vectors is stored in the object itself, so removals are O(1).
+       */
+      std::vector<DGNode<T> *> allNodes;
+      std::vector<DGEdge<T> *> allEdges;
       DGNode<T> *entryNode;
       std::unordered_map<T *, DGNode<T> *> internalNodeMap;
       std::unordered_map<T *, DGNode<T> *> externalNodeMap;
+
+    private:
+      DGArena<DGNode<T>> nodeArena;
+      DGArena<DGEdge<T>> edgeArena;
+
+      void appendEdge (DGEdge<T> *edge);
+      void releaseEdge (DGEdge<T> *edge);
   };
 
   template <class T>
@@ -179,8 +285,8 @@ namespace llvm {
   {
     public:
       typedef typename std::vector<DGNode<T> *>::iterator nodes_iterator;
-      typedef typename std::unordered_set<DGEdge<T> *>::iterator edges_iterator;
-      typedef typename std::unordered_set<DGEdge<T> *>::const_iterator edges_const_iterator;
+      typedef typename std::vector<DGEdge<T> *>::iterator edges_iterator;
+      typedef typename std::vector<DGEdge<T> *>::const_iterator edges_const_iterator;
 
       edges_iterator begin_outgoing_edges() { return outgoingEdges.begin(); }
       edges_iterator end_outgoing_edges() { return outgoingEdges.end(); }
@@ -218,13 +324,18 @@ namespace llvm {
       raw_ostream &print(raw_ostream &stream);
 
     protected:
-      DGNode(int32_t id) : ID{id}, theT(nullptr) {}
-      DGNode(int32_t id, T *node) : ID{id}, theT(node) {}
+      DGNode(int32_t id) : ID{id}, theT(nullptr), positionInGraph{0} {}
+      DGNode(int32_t id, T *node) : ID{id}, theT(node), positionInGraph{0} {}
 
       int32_t ID;
       T *theT;
-      std::unordered_set<DGEdge<T> *> outgoingEdges;
-      std::unordered_set<DGEdge<T> *> incomingEdges;
+      uint32_t positionInGraph;
+      std::vector<DGEdge<T> *> outgoingEdges;
+      std::vector<DGEdge<T> *> incomingEdges;
+
+    private:
+      void removeOutgoingEdgeAt(uint32_t position);
+      void removeIncomingEdgeAt(uint32_t position);
 
     friend class DG<T>;
   };
@@ -242,21 +353,22 @@ namespace llvm {
   {
    public:
      DGEdgeBase(DGNode<T> *src, DGNode<T> *dst)
-         : from(src), to(dst), memory(false), must(false),
-           dataDepType(DG_DATA_NONE), isControl(false), isLoopCarried(false),
-           isRemovable(false), remeds(nullptr) {}
+         : from(src), to(dst), positionInGraph{0}, positionInSource{0},
+           positionInDestination{0}, memory(false), must(false),
+           isControl(false), isLoopCarried(false), isRemovable(false),
+           dataDepType(DG_DATA_NONE), remeds(nullptr) {}
      DGEdgeBase(const DGEdgeBase<T, SubT> &oldEdge);
 
      typedef typename std::unordered_set<DGEdge<SubT> *>::iterator edges_iterator;
      typedef typename std::unordered_set<DGEdge<SubT> *>::const_iterator edges_const_iterator;
 
-     edges_iterator begin_sub_edges() { return subEdges.begin(); }
-     edges_iterator end_sub_edges() { return subEdges.end(); }
-     edges_const_iterator begin_sub_edges() const { return subEdges.begin(); }
-     edges_const_iterator end_sub_edges() const { return subEdges.end(); }
+     edges_iterator begin_sub_edges() { return getSubEdgeSet().begin(); }
+     edges_iterator end_sub_edges() { return getSubEdgeSet().end(); }
+     edges_const_iterator begin_sub_edges() const { return getSubEdgeSet().begin(); }
+     edges_const_iterator end_sub_edges() const { return getSubEdgeSet().end(); }
 
      inline iterator_range<edges_iterator> getSubEdges() {
-       return make_range(subEdges.begin(), subEdges.end()); }
+       return make_range(begin_sub_edges(), end_sub_edges()); }
 
     std::pair<DGNode<T> *, DGNode<T> *> getNodePair() const { return std::make_pair(from, to); }
     void setNodePair(DGNode<T> *from, DGNode<T> *to) { this->from = from; this->to = to; }
@@ -306,10 +418,13 @@ namespace llvm {
     }
 
     void addSubEdge(DGEdge<SubT> *edge) {
-      subEdges.insert(edge);
+      if (!subEdges) {
+        subEdges = std::make_unique<std::unordered_set<DGEdge<SubT> *>>();
+      }
+      subEdges->insert(edge);
       isLoopCarried |= edge->isLoopCarriedDependence();
       if (edge->isRemovableDependence() &&
-          (subEdges.size() == 1 || this->isRemovableDependence())) {
+          (subEdges->size() == 1 || this->isRemovableDependence())) {
         isRemovable = true;
         if (auto optional_remeds = edge->getRemedies()){
           for (auto &r : *(optional_remeds))
@@ -321,10 +436,12 @@ namespace llvm {
       }
     }
 
-    void removeSubEdge(DGEdge<SubT> *edge) { subEdges.erase(edge); }
+    void removeSubEdge(DGEdge<SubT> *edge) {
+      if (subEdges) subEdges->erase(edge);
+    }
 
     void clearSubEdges() {
-      subEdges.clear();
+      subEdges = nullptr;
       setLoopCarried(false);
       remeds = nullptr;
       setRemovable(false);
@@ -343,28 +460,53 @@ namespace llvm {
    protected:
     DGNode<T> *from;
     DGNode<T> *to;
-    std::unordered_set<DGEdge<SubT> *> subEdges;
 
-    // TODO: Use LLVM's bit set (keep getters the same)
-    bool memory;
-    bool must;
-    bool isControl;
-    bool isLoopCarried;
-    bool isRemovable;
+    /*
+     * Positions of this edge within the edges of its graph, within the outgoing edges of its source, and within the incoming edges of its destination.
+     */
+    uint32_t positionInGraph;
+    uint32_t positionInSource;
+    uint32_t positionInDestination;
 
-    DataDependenceType dataDepType;
+    bool memory : 1;
+    bool must : 1;
+    bool isControl : 1;
+    bool isLoopCarried : 1;
+    bool isRemovable : 1;
+    DataDependenceType dataDepType : 2;
+
+    /*
+     * Most edges have no sub-edges, so the set is allocated only when the first one is added.
+     */
+    std::unique_ptr<std::unordered_set<DGEdge<SubT> *>> subEdges;
 
     SetOfRemedies_ptr remeds;
+
+   private:
+    std::unordered_set<DGEdge<SubT> *> & getSubEdgeSet() const {
+      static std::unordered_set<DGEdge<SubT> *> noSubEdges;
+      return subEdges ? *subEdges : noSubEdges;
+    }
+
+    friend class DG<T>;
+    friend class DGNode<T>;
   };
 
   /*
    * DG<T> class method implementations
    */
+  template <class T>
+  DG<T>::~DG()
+  {
+    this->clear();
+  }
+
   template <class T>
   DGNode<T> *DG<T>::addNode(T *theT, bool inclusion)
   {
-    auto node = new DGNode<T>(nodeIdCounter++, theT);
-    allNodes.insert(node);
+    auto node = new (nodeArena.allocate()) DGNode<T>(nodeIdCounter++, theT);
+    node->positionInGraph = allNodes.size();
+    allNodes.push_back(node);
     auto &map = inclusion ? internalNodeMap : externalNodeMap;
     map[theT] = node;
     return node;
@@ -396,13 +538,35 @@ namespace llvm {
   {
     auto fromNode = fetchNode(from);
     auto toNode = fetchNode(to);
-    auto edge = new DGEdge<T>(fromNode, toNode);
-    allEdges.insert(edge);
-    fromNode->addOutgoingEdge(edge);
-    toNode->addIncomingEdge(edge);
+    auto edge = new (edgeArena.allocate()) DGEdge<T>(fromNode, toNode);
+    appendEdge(edge);
     return edge;
   }
 
+  template <class T>
+  void DG<T>::appendEdge(DGEdge<T> *edge)
+  {
+    edge->positionInGraph = allEdges.size();
+    allEdges.push_back(edge);
+    edge->getOutgoingNode()->addOutgoingEdge(edge);
+    edge->getIncomingNode()->addIncomingEdge(edge);
+  }
+
+  template <class T>
+  void DG<T>::releaseEdge(DGEdge<T> *edge)
+  {
+
+    /*
+     * Move the last edge of the graph into the slot of the edge to release.
+     */
+    auto lastEdge = allEdges.back();
+    allEdges[edge->positionInGraph] = lastEdge;
+    lastEdge->positionInGraph = edge->positionInGraph;
+    allEdges.pop_back();
+
+    edgeArena.release(edge);
+  }
+
   template <class T>
   std::unordered_set<DGEdge<T> *> DG<T>::fetchEdges(DGNode<T> *From, DGNode<T> *To) {
     std::unordered_set<DGEdge<T> *> edgeSet;
@@ -419,8 +583,7 @@ namespace llvm {
   template <class T>
   DGEdge<T> *DG<T>::copyAddEdge(DGEdge<T> &edgeToCopy)
   {
-    auto edge = new DGEdge<T>(edgeToCopy);
-    allEdges.insert(edge);
+    auto edge = new (edgeArena.allocate()) DGEdge<T>(edgeToCopy);
 
     /*
      * Point copy of edge to equivalent nodes in this graph
@@ -430,8 +593,7 @@ namespace llvm {
     auto toNode = fetchNode(nodePair.second->getT());
     edge->setNodePair(fromNode, toNode);
 
-    fromNode->addOutgoingEdge(edge);
-    toNode->addIncomingEdge(edge);
+    appendEdge(edge);
     return edge;
   }
 
@@ -583,39 +745,42 @@ namespace llvm {
     auto theT = node->getT();
     auto &map = isInternal(theT) ? internalNodeMap : externalNodeMap;
     map.erase(theT);
-    allNodes.erase(node);
+
+    auto lastNode = allNodes.back();
+    allNodes[node->positionInGraph] = lastNode;
+    lastNode->positionInGraph = node->positionInGraph;
+    allNodes.pop_back();
 
     /*
-     * Collect edges to operate on before doing deletes
+     * Detach the edges of the node from its neighbors
      */
-    std::unordered_set<DGEdge<T> *> incomingToNode;
-    std::unordered_set<DGEdge<T> *> outgoingFromNode;
-    std::unordered_set<DGEdge<T> *> allToAndFromNode;
-    for (auto edge : node->getIncomingEdges()) incomingToNode.insert(edge);
-    for (auto edge : node->getOutgoingEdges()) outgoingFromNode.insert(edge);
-    for (auto edge : node->getAllConnectedEdges()) allToAndFromNode.insert(edge);
+    for (auto edge : node->outgoingEdges) {
+      auto toNode = edge->getIncomingNode();
+      if (toNode != node) toNode->removeIncomingEdgeAt(edge->positionInDestination);
+    }
+    for (auto edge : node->incomingEdges) {
+      auto fromNode = edge->getOutgoingNode();
+      if (fromNode != node) fromNode->removeOutgoingEdgeAt(edge->positionInSource);
+    }
 
     /*
-     * Delete relations to edges and edges themselves
+     * Delete the edges themselves; self edges belong to both lists
      */
-    for (auto edge : incomingToNode) edge->getOutgoingNode()->removeConnectedNode(node);
-    for (auto edge : outgoingFromNode) edge->getIncomingNode()->removeConnectedNode(node);
-    for (auto edge : allToAndFromNode)
-    {
-      allEdges.erase(edge);
-      delete edge;
+    for (auto edge : node->outgoingEdges) releaseEdge(edge);
+    for (auto edge : node->incomingEdges) {
+      if (edge->getOutgoingNode() == node) continue;
+      releaseEdge(edge);
     }
 
-    delete node;
+    nodeArena.release(node);
   }
 
   template <class T>
   void DG<T>::removeEdge(DGEdge<T> *edge)
   {
-    edge->getOutgoingNode()->removeConnectedEdge(edge);
-    edge->getIncomingNode()->removeConnectedEdge(edge);
-    allEdges.erase(edge);
-    delete edge;
+    edge->getOutgoingNode()->removeOutgoingEdgeAt(edge->positionInSource);
+    edge->getIncomingNode()->removeIncomingEdgeAt(edge->positionInDestination);
+    releaseEdge(edge);
   }
 
   template <class T>
@@ -645,6 +810,11 @@ namespace llvm {
   template <class T>
   void DG<T>::clear()
   {
+    for (auto edge : allEdges) edge->~DGEdge<T>();
+    for (auto node : allNodes) node->~DGNode<T>();
+    edgeArena.reset();
+    nodeArena.reset();
+
     allNodes.clear();
     allEdges.clear();
     entryNode = nullptr;
@@ -652,6 +822,43 @@ namespace llvm {
     externalNodeMap.clear();
   }
 
+  template <class T>
+  uint64_t DG<T>::getMemoryFootprint() const
+  {
+    uint64_t bytes = sizeof(DG<T>);
+
+    /*
+     * Nodes, edges, and the vectors that index them.
+     */
+    bytes += nodeArena.getNumberOfBytesAllocated();
+    bytes += edgeArena.getNumberOfBytesAllocated();
+    bytes += allNodes.capacity() * sizeof(DGNode<T> *);
+    bytes += allEdges.capacity() * sizeof(DGEdge<T> *);
+
+    /*
+     * Adjacency lists and sub-edges.
+     */
+    for (auto node : allNodes)
+    {
+      bytes += (node->outgoingEdges.capacity() + node->incomingEdges.capacity()) * sizeof(DGEdge<T> *);
+    }
+    for (auto edge : allEdges)
+    {
+      if (!edge->subEdges) continue;
+      bytes += sizeof(*edge->subEdges) + edge->subEdges->bucket_count() * sizeof(void *) + edge->subEdges->size() * 2 * sizeof(void *);
+    }
+
+    /*
+     * Maps from T to nodes: one bucket pointer per bucket, and one heap node (next pointer, key, value) per element.
+     */
+    for (auto nodeMap : { &internalNodeMap, &externalNodeMap })
+    {
+      bytes += nodeMap->bucket_count() * sizeof(void *) + nodeMap->size() * 3 * sizeof(void *);
+    }
+
+    return bytes;
+  }
+
   template <class T>
   raw_ostream & DG<T>::print(raw_ostream &stream)
   {
@@ -671,54 +878,71 @@ namespace llvm {
   template <class T>
   void DGNode<T>::addIncomingEdge(DGEdge<T> *edge)
   {
-    incomingEdges.insert(edge);
-    auto node = edge->getOutgoingNode();
+    edge->positionInDestination = incomingEdges.size();
+    incomingEdges.push_back(edge);
   }
 
   template <class T>
   void DGNode<T>::addOutgoingEdge(DGEdge<T> *edge)
   {
-    outgoingEdges.insert(edge);
-    auto node = edge->getIncomingNode();
+    edge->positionInSource = outgoingEdges.size();
+    outgoingEdges.push_back(edge);
+  }
+
+  template <class T>
+  void DGNode<T>::removeOutgoingEdgeAt(uint32_t position)
+  {
+    auto lastEdge = outgoingEdges.back();
+    outgoingEdges[position] = lastEdge;
+    lastEdge->positionInSource = position;
+    outgoingEdges.pop_back();
+  }
+
+  template <class T>
+  void DGNode<T>::removeIncomingEdgeAt(uint32_t position)
+  {
+    auto lastEdge = incomingEdges.back();
+    incomingEdges[position] = lastEdge;
+    lastEdge->positionInDestination = position;
+    incomingEdges.pop_back();
   }
 
   template <class T>
   void DGNode<T>::removeConnectedEdge(DGEdge<T> *edge)
   {
-    DGNode<T> *node;
-    if (outgoingEdges.find(edge) != outgoingEdges.end())
-    {
-      outgoingEdges.erase(edge);
-      node = edge->getIncomingNode();
+
+    /*
+     * A self edge is in both lists: the outgoing one is removed first
+     */
+    auto position = edge->positionInSource;
+    if (  (position < outgoingEdges.size())
+        && (outgoingEdges[position] == edge)) {
+      removeOutgoingEdgeAt(position);
+      return ;
     }
-    else
-    {
-      incomingEdges.erase(edge);
-      node = edge->getOutgoingNode();
+    position = edge->positionInDestination;
+    if (  (position < incomingEdges.size())
+        && (incomingEdges[position] == edge)) {
+      removeIncomingEdgeAt(position);
     }
   }
 
   template <class T>
   void DGNode<T>::removeConnectedNode(DGNode<T> *node)
   {
-    std::unordered_set<DGEdge<T> *> outgoingEdgesToRemove{};
-    for (auto edge : outgoingEdges) {
-      if (edge->getIncomingNode() == node) {
-        outgoingEdgesToRemove.insert(edge);
-      }
-    }
-    for (auto edge : outgoingEdgesToRemove) {
-      outgoingEdges.erase(edge);
-    }
 
-    std::unordered_set<DGEdge<T> *> incomingEdgesToRemove{};
-    for (auto edge : incomingEdges) {
-      if (edge->getOutgoingNode() == node) {
-        incomingEdgesToRemove.insert(edge);
+    /*
+     * Walk backward so the edges moved into the freed slots have been visited already
+     */
+    for (auto i = outgoingEdges.size(); i > 0; i--) {
+      if (outgoingEdges[i - 1]->getIncomingNode() == node) {
+        removeOutgoingEdgeAt(i - 1);
       }
     }
-    for (auto edge : incomingEdgesToRemove) {
-      incomingEdges.erase(edge);
+    for (auto i = incomingEdges.size(); i > 0; i--) {
+      if (incomingEdges[i - 1]->getOutgoingNode() == node) {
+        removeIncomingEdgeAt(i - 1);
+      }
     }
   }
 
@@ -754,6 +978,7 @@ namespace llvm {
    */
   template <class T, class SubT>
   DGEdgeBase<T, SubT>::DGEdgeBase(const DGEdgeBase<T, SubT> &oldEdge)
+    : positionInGraph{0}, positionInSource{0}, positionInDestination{0}
   {
     auto nodePair = oldEdge.getNodePair();
     from = nodePair.first;
@@ -763,7 +988,7 @@ namespace llvm {
     setLoopCarried(oldEdge.isLoopCarriedDependence());
     setRemovable(oldEdge.isRemovableDependence());
     setRemedies(oldEdge.getRemedies());
-    for (auto subEdge : oldEdge.subEdges) addSubEdge(subEdge);
+    for (auto subEdge : make_range(oldEdge.begin_sub_edges(), oldEdge.end_sub_edges())) addSubEdge(subEdge);
   }
 
   template <class T, class SubT>
@@ -786,10 +1011,10 @@ namespace llvm {
   template <class T, class SubT>
   std::string DGEdgeBase<T, SubT>::toString()
   {
-    if (this->subEdges.size() > 0) {
+    if (this->subEdges && this->subEdges->size() > 0) {
       std::string edgesStr;
       raw_string_ostream ros(edgesStr);
-      for (auto edge : this->subEdges) ros << edge->toString();
+      for (auto edge : *(this->subEdges)) ros << edge->toString();
       return ros.str();
     }
     if (this->isControlDependence()) return "CTRL";
@@ -117,6 +117,28 @@ namespace llvm {
         Value *to
         );
 
+      /*
+       * Remove the nodes and dependences of an old version of a function.
+       * @oldValues are the arguments and instructions of the function that are included in this PDG.
+       * They are only used as keys, so they can include instructions that have been deleted.
+       * Return true if the entry node of the PDG has been removed.
+       *
+       * A new instruction can reuse the address of a deleted one, even of another function.
+       * Hence, when several functions change, the old versions of all of them must be removed before adding any new version.
+       */
+      bool removeFunctionSubgraph (
+        std::vector<Value *> const &oldValues
+        );
+
+      /*
+       * Add the nodes and dependences of @functionDG, which has been computed for the current body of a function.
+       * If @isEntry is true, then the entry node of @functionDG becomes the entry node of the PDG.
+       */
+      void addFunctionSubgraph (
+        PDG *functionDG,
+        bool isEntry
+        );
+
       /*
        * Creating Program Dependence Subgraphs
        */
@@ -21,6 +21,7 @@
 #include "TalkDown.hpp"
 #include "DataFlow.hpp"
 #include "CallGraph.hpp"
+#include "AliasQueryCache.hpp"
 
 using namespace llvm;
 
@@ -47,12 +48,29 @@ namespace llvm {
 
       PDG * getPDG (void) ;
 
+      /*
+       * Notify the analysis that a transformation has changed the function @F.
+       * The dependences of @F are recomputed the next time the PDG (or the DG of @F) is requested; those of the other functions are kept.
+       * The DG of @F previously returned by getFunctionPDG is freed.
+       */
+      void invalidateFunction (Function &F) ;
+
       noelle::CallGraph * getProgramCallGraph (void);
 
+      /*
+       * Results of the alias analysis queries issued while computing dependences.
+       * Clients that refine dependences (e.g., loop-aware analyses) can share it.
+       * These results are valid only for the current IR: they are dropped when the PDG is rebuilt and when a function is invalidated.
+       */
+      AliasQueryCache * getAliasQueryCache (void);
+
     private:
       Module *M;
       PDG *programDependenceGraph;
       std::unordered_map<Function *, PDG *> functionToFDGMap;
+      std::unordered_map<Function *, std::vector<Value *>> valuesOfFunctions;
+      std::unordered_set<Function *> invalidatedFunctions;
+      std::unordered_set<Function *> functionsModifiedAfterSVF;
       AllocAA *allocAA;
       std::set<Function *> CGUnderMain;
       TalkDown *talkdown;
@@ -64,16 +82,23 @@ namespace llvm {
       bool disableSVF;
       bool disableAllocAA;
       bool disableRA;
+      uint32_t numberOfThreads;
+      uint64_t numberOfAvoidedAliasQueries;
       PDGPrinter printer;
       PointerAnalysis *pta;
       PTACallGraph *callGraph;
       MemSSA *mssa;
+      AliasQueryCache aliasQueryCache;
 
       std::unordered_set<const Function *> internalFuncs;
       std::unordered_set<const Function *> unhandledExternalFuncs;
       std::unordered_map<const Function *, std::unordered_set<const Function *>> reachableUnhandledExternalFuncs;
       
       void initializeSVF(Module &M);
+      bool canUseSVF(Function &F);
+      void recordValuesOfFunctions(Module &M);
+      void recordValuesOfFunction(Function &F);
+      void updateInvalidatedFunctions(void);
       void identifyFunctionsThatInvokeUnhandledLibrary(Module &M);
       void printFunctionReachabilityResult();
       bool isSafeToQueryModRefOfSVF(CallInst *call, BitVector &bv);
@@ -90,32 +115,59 @@ namespace llvm {
 
       PDG * constructPDGFromMetadata(Module &);
       PDG * constructFunctionDGFromMetadata(Function &);
-      void constructNodesFromMetadata(PDG *, Function &, unordered_map<MDNode *, Value *> &);
-      void constructEdgesFromMetadata(PDG *, Function &, unordered_map<MDNode *, Value *> &);
-      DGEdge<Value> * constructEdgeFromMetadata(PDG *, MDNode *, unordered_map<MDNode *, Value *> &);
+      StringRef fetchEmbeddedPDG(Module &);
+      bool constructEdgesFromEmbeddedPDG(PDG *, StringRef embeddedPDG, Function *onlyFunction);
 
       void embedPDGAsMetadata(PDG *);
-      void embedNodesAsMetadata(PDG *, LLVMContext &, unordered_map<Value *, MDNode *> &);
-      void embedEdgesAsMetadata(PDG *, LLVMContext &, unordered_map<Value *, MDNode *> &);
-      MDNode * getEdgeMetadata(DGEdge<Value> *, LLVMContext &, unordered_map<Value *, MDNode *> &);
-      MDNode * getSubEdgesMetadata(DGEdge<Value> *, LLVMContext &, unordered_map<Value *, MDNode *> &);
 
       void trimDGUsingCustomAliasAnalysis (PDG *pdg);
 
       // TODO: Find a way to extract this into a helper module for all passes in the PDG project
       void collectCGUnderFunctionMain (Module &M);
 
+      /*
+       * Control dependences of a function as (terminator, dependent basic block) pairs.
+       * Each pair stands for the control dependences from the terminator to all instructions of the basic block, which are expanded only when the edges are added to the PDG.
+       */
+      typedef std::vector<std::pair<Instruction *, BasicBlock *>> ControlDependences;
+
       PDG * constructPDGFromAnalysis(Module &M);
       PDG * constructFunctionDGFromAnalysis(Function &F);
       void constructEdgesFromUseDefs (PDG *pdg);
       void constructEdgesFromAliases (PDG *pdg, Module &M);
       void constructEdgesFromControl (PDG *pdg, Module &M);
+
+      /*
+       * Only the reachable memory instructions and the control dependences of each function are computed by the worker threads.
+       * The alias analyses are then queried by the calling thread, one function at a time, because the legacy pass manager and SVF are not thread safe.
+       * Hence the speedup is bounded by the fraction of the construction spent outside alias queries.
+       * Workers run only a few functions ahead of the calling thread, so only a few reachability results are alive at any time.
+       */
+      void constructEdgesFromAliasesAndControlInParallel (PDG *pdg, Module &M);
       void constructEdgesFromAliasesForFunction (PDG *pdg, Function &F);
+      void constructEdgesFromAliasesForFunction (PDG *pdg, Function &F, DataFlowResult *dfr);
       void constructEdgesFromControlForFunction (PDG *pdg, Function &F);
-
-      void iterateInstForStore(PDG *, Function &, AAResults &, DataFlowResult *, StoreInst *);
-      void iterateInstForLoad(PDG *, Function &, AAResults &, DataFlowResult *, LoadInst *);
-      void iterateInstForCall(PDG *, Function &, AAResults &, DataFlowResult *, CallInst *);
+      void constructEdgesFromControlForFunction (PDG *pdg, Function &F, ControlDependences &controlDependences);
+
+      /*
+       * Compute the memory instructions that can execute after each memory instruction of @F.
+       * The result is dense (see DataFlowResult) or, if the reachability analysis is disabled, it includes all instructions of @F symbolically.
+       */
+      DataFlowResult * computeReachableMemoryInstructions (Function &F);
+
+      /*
+       * Identified object (e.g., alloca, global, noalias call) accessed by loads and stores of a function.
+       * Memory instructions that access an unknown object are not included.
+       */
+      typedef std::unordered_map<Instruction *, const Value *> MemoryObjectPartition;
+
+      MemoryObjectPartition partitionMemoryInstructions (Function &F);
+      bool canAccessTheSameObject (MemoryObjectPartition &partition, Instruction *i, Instruction *j);
+      ControlDependences computeControlDependences (Function &F, PostDominatorTree &postDomTree);
+
+      void iterateInstForStore(PDG *, Function &, AAResults &, MemoryObjectPartition &, DataFlowResult *, StoreInst *);
+      void iterateInstForLoad(PDG *, Function &, AAResults &, MemoryObjectPartition &, DataFlowResult *, LoadInst *);
+      void iterateInstForCall(PDG *, Function &, AAResults &, MemoryObjectPartition &, DataFlowResult *, CallInst *);
       
       template<class InstI, class InstJ>
       void addEdgeFromMemoryAlias(PDG *, Function &, AAResults &, InstI *, InstJ *, DataDependenceType);
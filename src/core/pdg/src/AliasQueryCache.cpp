@@ -0,0 +1,249 @@
+/*
+ * Copyright 2016 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "llvm/ADT/Hashing.h"
+
+#include "AliasQueryCache.hpp"
+
+using namespace llvm;
+
+static const char *queryKindNames[] = {
+  "LLVM alias",
+  "SVF alias",
+  "LLVM mod/ref",
+  "SVF mod/ref",
+  "SCAF loop-carried",
+  "SCAF intra-iteration"
+};
+
+AliasQueryCache::AliasQueryCache () {
+  this->hits.fill(0);
+  this->misses.fill(0);
+
+  return ;
+}
+
+AliasResult AliasQueryCache::alias (
+  QueryKind kind,
+  const MemoryLocation &location1,
+  const MemoryLocation &location2,
+  std::function<AliasResult (void)> query
+  ){
+
+  /*
+   * Alias queries are symmetric.
+   * Hence, we store the two locations in a canonical order so that (A, B) and (B, A) share the same entry.
+   */
+  QueryKey first{}, second{};
+  this->fillLocation(first, 0, location1);
+  this->fillLocation(second, 0, location2);
+  if (second < first){
+    std::swap(first, second);
+  }
+  QueryKey key{};
+  key[0] = kind;
+  std::copy(first.begin(), first.begin() + 5, key.begin() + 1);
+  std::copy(second.begin(), second.begin() + 5, key.begin() + 6);
+
+  auto result = this->lookup(key, kind, [&query](void) -> uint8_t {
+    return static_cast<uint8_t>(query());
+  });
+  this->track(location1.Ptr);
+  this->track(location2.Ptr);
+
+  return static_cast<AliasResult>(result);
+}
+
+ModRefInfo AliasQueryCache::getModRefInfo (
+  QueryKind kind,
+  const CallInst *call,
+  const MemoryLocation &location,
+  std::function<ModRefInfo (void)> query
+  ){
+
+  /*
+   * The key includes the call instruction rather than its callee: the arguments of the call site affect the result.
+   */
+  QueryKey key{};
+  key[0] = kind;
+  key[1] = reinterpret_cast<uintptr_t>(call);
+  this->fillLocation(key, 2, location);
+
+  auto result = this->lookup(key, kind, [&query](void) -> uint8_t {
+    return static_cast<uint8_t>(query());
+  });
+  this->track(call);
+  this->track(location.Ptr);
+
+  return static_cast<ModRefInfo>(result);
+}
+
+ModRefInfo AliasQueryCache::getModRefInfo (
+  QueryKind kind,
+  const CallInst *call,
+  const CallInst *otherCall,
+  std::function<ModRefInfo (void)> query
+  ){
+
+  /*
+   * Mod/ref queries between calls are not symmetric, so the order of the two calls is part of the key.
+   */
+  QueryKey key{};
+  key[0] = kind;
+  key[1] = reinterpret_cast<uintptr_t>(call);
+  key[2] = reinterpret_cast<uintptr_t>(otherCall);
+
+  auto result = this->lookup(key, kind, [&query](void) -> uint8_t {
+    return static_cast<uint8_t>(query());
+  });
+  this->track(call);
+  this->track(otherCall);
+
+  return static_cast<ModRefInfo>(result);
+}
+
+uint8_t AliasQueryCache::disproveMemoryDependences (
+  QueryKind kind,
+  const Instruction *from,
+  const Instruction *to,
+  uint8_t dependenceTypes,
+  const Loop *loop,
+  std::function<uint8_t (void)> query
+  ){
+
+  /*
+   * Loops are identified by their header.
+   * Loop objects are freed and reallocated every time the loop information of a function is recomputed, while headers are stable.
+   */
+  auto header = loop->getHeader();
+  QueryKey key{};
+  key[0] = kind;
+  key[1] = reinterpret_cast<uintptr_t>(from);
+  key[2] = reinterpret_cast<uintptr_t>(to);
+  key[3] = dependenceTypes;
+  key[4] = reinterpret_cast<uintptr_t>(header);
+
+  auto result = this->lookup(key, kind, query);
+  this->track(from);
+  this->track(to);
+  this->track(header);
+
+  return result;
+}
+
+uint8_t AliasQueryCache::lookup (
+  QueryKey const &key,
+  QueryKind kind,
+  std::function<uint8_t (void)> query
+  ){
+
+  /*
+   * Check if we have already answered this query.
+   */
+  auto it = this->results.find(key);
+  if (it != this->results.end()){
+    this->hits[kind]++;
+    return it->second;
+  }
+
+  /*
+   * Ask the analysis.
+   */
+  this->misses[kind]++;
+  auto result = query();
+  this->results[key] = result;
+
+  return result;
+}
+
+void AliasQueryCache::track (const Value *value){
+  if (value == nullptr){
+    return ;
+  }
+  if (this->trackedValues.find(value) != this->trackedValues.end()){
+    return ;
+  }
+
+  auto handle = std::make_unique<DeletionHandle>(const_cast<Value *>(value), this);
+  this->trackedValues[value] = std::move(handle);
+
+  return ;
+}
+
+void AliasQueryCache::fillLocation (QueryKey &key, uint32_t index, const MemoryLocation &location){
+  key[index] = reinterpret_cast<uintptr_t>(location.Ptr);
+  key[index + 1] = static_cast<uintptr_t>(location.Size.toRaw());
+  key[index + 2] = reinterpret_cast<uintptr_t>(location.AATags.TBAA);
+  key[index + 3] = reinterpret_cast<uintptr_t>(location.AATags.Scope);
+  key[index + 4] = reinterpret_cast<uintptr_t>(location.AATags.NoAlias);
+
+  return ;
+}
+
+void AliasQueryCache::clear (void){
+
+  /*
+   * Drop the results.
+   * Statistics are kept as they describe the whole compilation.
+   */
+  this->results.clear();
+  this->trackedValues.clear();
+
+  return ;
+}
+
+uint64_t AliasQueryCache::getNumberOfHits (QueryKind kind) const {
+  return this->hits[kind];
+}
+
+uint64_t AliasQueryCache::getNumberOfMisses (QueryKind kind) const {
+  return this->misses[kind];
+}
+
+raw_ostream & AliasQueryCache::printStatistics (raw_ostream &stream) const {
+  stream << "AliasQueryCache: Statistics\n";
+  for (auto kind = 0; kind < NUMBER_OF_QUERY_KINDS; kind++){
+    auto total = this->hits[kind] + this->misses[kind];
+    if (total == 0){
+      continue ;
+    }
+    stream << "AliasQueryCache:   " << queryKindNames[kind] << ": " << this->hits[kind] << " hits, " << this->misses[kind] << " misses (" << ((this->hits[kind] * 100) / total) << "% hit rate)\n";
+  }
+
+  return stream;
+}
+
+AliasQueryCache::~AliasQueryCache (){
+  this->clear();
+
+  return ;
+}
+
+size_t AliasQueryCache::QueryKeyHash::operator() (const QueryKey &key) const {
+  return hash_combine_range(key.begin(), key.end());
+}
+
+AliasQueryCache::DeletionHandle::DeletionHandle (Value *value, AliasQueryCache *cache)
+  : CallbackVH(value), cache{cache} {
+  return ;
+}
+
+void AliasQueryCache::DeletionHandle::deleted (void) {
+
+  /*
+   * A value used as part of a key has been deleted.
+   * Its address could be reused by a new value, so no cached result can be trusted anymore.
+   *
+   * Notice that clearing the cache destroys this handle as well, so nothing can be accessed after it.
+   */
+  this->cache->clear();
+
+  return ;
+}
@@ -129,6 +129,56 @@ PDG * PDG::createFunctionSubgraph(Function &F) {
   return functionPDG;
 }
 
+bool PDG::removeFunctionSubgraph (std::vector<Value *> const &oldValues) {
+
+  /*
+   * Remove the nodes of the old version of the function together with their dependences.
+   * Dependences never cross function boundaries, so the rest of the PDG is not affected.
+   */
+  auto entryRemoved = false;
+  for (auto value : oldValues) {
+    auto nodeIt = this->internalNodeMap.find(value);
+    if (nodeIt == this->internalNodeMap.end()) {
+      continue ;
+    }
+    if (nodeIt->second == this->entryNode) {
+      entryRemoved = true;
+    }
+    this->removeNode(nodeIt->second);
+  }
+
+  return entryRemoved;
+}
+
+void PDG::addFunctionSubgraph (PDG *functionDG, bool isEntry) {
+
+  /*
+   * Add the nodes of the new version of the function.
+   */
+  for (auto nodePair : functionDG->internalNodePairs()) {
+    this->addNode(nodePair.first, /*inclusion=*/ true);
+  }
+  if (isEntry) {
+    this->entryNode = this->internalNodeMap[functionDG->getEntryNode()->getT()];
+  }
+
+  /*
+   * Add the dependences of the new version of the function.
+   */
+  for (auto edge : functionDG->getEdges()) {
+    auto nodePair = edge->getNodePair();
+    if (  false
+          || !this->isInternal(nodePair.first->getT())
+          || !this->isInternal(nodePair.second->getT())
+      ) {
+      continue ;
+    }
+    this->copyAddEdge(*edge);
+  }
+
+  return ;
+}
+
 PDG * PDG::createLoopsSubgraph(Loop *loop) {
 
   /*
@@ -168,9 +218,13 @@ void PDG::copyEdgesInto (PDG *newPDG, bool linkToExternal) {
 }
 
 void PDG::copyEdgesInto (PDG *newPDG, bool linkToExternal, std::unordered_set<DGEdge<Value> *> const & edgesToIgnore) {
-  for (auto *oldEdge : allEdges) {
+
+  /*
+   * Define the code to copy an edge.
+   */
+  auto copyEdge = [newPDG, linkToExternal, &edgesToIgnore](DGEdge<Value> *oldEdge) -> void {
     if (edgesToIgnore.find(oldEdge) != edgesToIgnore.end()) {
-      continue;
+      return ;
     }
 
     auto nodePair = oldEdge->getNodePair();
@@ -183,10 +237,10 @@ void PDG::copyEdgesInto (PDG *newPDG, bool linkToExternal, std::unordered_set<DG
     auto fromInclusion = newPDG->isInternal(fromT);
     auto toInclusion = newPDG->isInternal(toT);
     if (!fromInclusion && !toInclusion) {
-      continue;
+      return ;
     }
     if (!linkToExternal && (!fromInclusion || !toInclusion)) {
-      continue;
+      return ;
     }
     
     /*
@@ -199,6 +253,41 @@ void PDG::copyEdgesInto (PDG *newPDG, bool linkToExternal, std::unordered_set<DG
      * Copy edge to match properties (mem/var, must/may, RAW/WAW/WAR/control)
      */
     newPDG->copyAddEdge(*oldEdge);
+  };
+
+  /*
+   * Only edges connected to internal nodes of the new PDG can be copied.
+   * So we visit the edges of these nodes rather than all edges of the current PDG.
+   * This keeps the cost proportional to the size of the new PDG.
+   */
+  for (auto internalNodePair : newPDG->internalNodePairs()) {
+
+    /*
+     * Fetch the node of the current PDG.
+     */
+    auto value = internalNodePair.first;
+    if (!this->isInGraph(value)) {
+      continue;
+    }
+    auto oldNode = this->fetchNode(value);
+
+    /*
+     * Copy the outgoing edges.
+     */
+    for (auto oldEdge : oldNode->getOutgoingEdges()) {
+      copyEdge(oldEdge);
+    }
+
+    /*
+     * Copy the incoming edges that come from nodes outside the new PDG.
+     * The others are copied as outgoing edges of their source.
+     */
+    for (auto oldEdge : oldNode->getIncomingEdges()) {
+      if (newPDG->isInternal(oldEdge->getOutgoingT())) {
+        continue;
+      }
+      copyEdge(oldEdge);
+    }
   }
 
   return ;
@@ -353,8 +442,5 @@ bool PDG::iterateOverDependencesTo (
 }
 
 PDG::~PDG() {
-  for (auto *edge : allEdges)
-    if (edge) delete edge;
-  for (auto *node : allNodes)
-    if (node) delete node;
+  return ;
 }
@@ -30,6 +30,8 @@ PDGAnalysis::PDGAnalysis()
     , disableSVF{false}
     , disableAllocAA{false}
     , disableRA{false}
+    , numberOfThreads{1}
+    , numberOfAvoidedAliasQueries{0}
     , printer{} 
   {
 
@@ -55,6 +57,10 @@ void PDGAnalysis::releaseMemory () {
     delete fdg;
   }
   this->functionToFDGMap.clear();
+  this->valuesOfFunctions.clear();
+  this->invalidatedFunctions.clear();
+
+  this->aliasQueryCache.clear();
 
   return ;
 }
@@ -95,6 +101,11 @@ PDG * PDGAnalysis::getFunctionPDG (Function &F) {
   PDG *pdg = nullptr;
   if (this->programDependenceGraph){
 
+    /*
+     * Bring the PDG up to date with the functions that have been modified.
+     */
+    this->updateInvalidatedFunctions();
+
     /*
      * Check and get/update the function cache
      */
@@ -117,7 +128,8 @@ PDG * PDGAnalysis::getFunctionPDG (Function &F) {
        */
       if (this->hasPDGAsMetadata(*this->M)) {
         pdg = constructFunctionDGFromMetadata(F);
-      } else {
+      }
+      if (pdg == nullptr) {
         pdg = constructFunctionDGFromAnalysis(F);
       }
       this->functionToFDGMap.insert(std::make_pair(&F, pdg));
@@ -144,6 +156,7 @@ PDG * PDGAnalysis::getPDG (void){
    * Check if we have already built the PDG.
    */
   if (this->programDependenceGraph){
+    this->updateInvalidatedFunctions();
     return this->programDependenceGraph;
   }
 
@@ -151,15 +164,16 @@ PDG * PDGAnalysis::getPDG (void){
    * Construct the PDG
    *
    * Check if we have already done it and the PDG has been embedded in the IR.
+   * The embedded PDG is not loaded if the IR has changed since it was embedded.
    */
   if (this->hasPDGAsMetadata(*this->M)) {
+    this->programDependenceGraph = constructPDGFromMetadata(*this->M);
+  }
+  if (this->programDependenceGraph) {
 
     /*
-     * The PDG has been embedded in the IR.
-     *
-     * Load the embedded PDG.
+     * The PDG has been embedded in the IR and it has been loaded.
      */
-    this->programDependenceGraph = constructPDGFromMetadata(*this->M);
     if (this->performThePDGComparison){
       auto PDGFromAnalysis = constructPDGFromAnalysis(*this->M);
       auto arePDGsEquivalent = this->comparePDGs(PDGFromAnalysis, this->programDependenceGraph);
@@ -173,12 +187,31 @@ PDG * PDGAnalysis::getPDG (void){
   } else {
 
     /*
-     * There is no PDG in the IR.
+     * There is no up-to-date PDG in the IR.
      * 
      * Compute the PDG using the dependence analyses.
      */
     this->programDependenceGraph = constructPDGFromAnalysis(*this->M);
 
+    /*
+     * Check the PDG computed by several threads against the one computed by a single thread.
+     */
+    if (  true
+          && this->performThePDGComparison
+          && (this->numberOfThreads > 1)
+      ){
+      auto threads = this->numberOfThreads;
+      this->numberOfThreads = 1;
+      auto serialPDG = constructPDGFromAnalysis(*this->M);
+      this->numberOfThreads = threads;
+      auto arePDGsEquivalent = this->comparePDGs(this->programDependenceGraph, serialPDG);
+      if (!arePDGsEquivalent){
+        errs() << "PDGAnalysis: Error = PDGs constructed are not the same";
+        abort();
+      }
+      delete serialPDG;
+    }
+
     /*
      * Check if we should embed the PDG.
      */
@@ -196,19 +229,124 @@ PDG * PDGAnalysis::getPDG (void){
     }
   }
 
+  /*
+   * Keep track of the values of each function.
+   * This allows us to remove the nodes of a function from the PDG after the function has been modified (and some of its instructions deleted).
+   */
+  this->recordValuesOfFunctions(*this->M);
+  this->invalidatedFunctions.clear();
+
   return this->programDependenceGraph;
 }
 
-bool PDGAnalysis::hasPDGAsMetadata(Module &M) {
-  if (auto n = M.getNamedMetadata("noelle.module.pdg")) {
-    if (auto m = dyn_cast<MDNode>(n->getOperand(0))) {
-      if (cast<MDString>(m->getOperand(0))->getString() == "true") {
-        return true;
-      }
+void PDGAnalysis::invalidateFunction (Function &F){
+
+  /*
+   * SVF has been computed for the original code of the module.
+   * Hence, it cannot be queried about the new instructions of @F.
+   */
+  this->functionsModifiedAfterSVF.insert(&F);
+
+  /*
+   * Cached alias queries might have been answered for operands that changed.
+   */
+  this->aliasQueryCache.clear();
+
+  /*
+   * Free the DG of the function.
+   */
+  auto fdgIt = this->functionToFDGMap.find(&F);
+  if (fdgIt != this->functionToFDGMap.end()){
+    delete fdgIt->second;
+    this->functionToFDGMap.erase(fdgIt);
+  }
+
+  /*
+   * Recompute the dependences of @F lazily.
+   */
+  if (this->programDependenceGraph){
+    this->invalidatedFunctions.insert(&F);
+  }
+
+  return ;
+}
+
+void PDGAnalysis::updateInvalidatedFunctions (void){
+
+  /*
+   * Remove the old dependences of all invalidated functions first.
+   * A new instruction of a function can reuse the address of a deleted instruction of another one; so removing the old values of a function after adding the new ones of another could remove the latter.
+   */
+  Function *functionWithEntry = nullptr;
+  for (auto F : this->invalidatedFunctions){
+    if (this->programDependenceGraph->removeFunctionSubgraph(this->valuesOfFunctions[F])){
+      functionWithEntry = F;
     }
   }
 
-  return false;
+  /*
+   * Add the dependences of the new version of the functions.
+   */
+  for (auto F : this->invalidatedFunctions){
+    if (verbose >= PDGVerbosity::Maximal) {
+      errs() << "PDGAnalysis: Recompute the dependences of " << F->getName() << "\n";
+    }
+    if (!F->empty()){
+      auto functionDG = this->constructFunctionDGFromAnalysis(*F);
+      this->programDependenceGraph->addFunctionSubgraph(functionDG, F == functionWithEntry);
+      delete functionDG;
+    }
+    this->recordValuesOfFunction(*F);
+  }
+  this->invalidatedFunctions.clear();
+
+  return ;
+}
+
+void PDGAnalysis::recordValuesOfFunctions (Module &M){
+  this->valuesOfFunctions.clear();
+  for (auto &F : M){
+    if (F.isDeclaration()){
+      continue ;
+    }
+    this->recordValuesOfFunction(F);
+  }
+
+  return ;
+}
+
+void PDGAnalysis::recordValuesOfFunction (Function &F){
+  auto &values = this->valuesOfFunctions[&F];
+  values.clear();
+  for (auto &arg : F.args()){
+    values.push_back(&arg);
+  }
+  for (auto &inst : instructions(F)){
+    values.push_back(&inst);
+  }
+
+  return ;
+}
+
+bool PDGAnalysis::canUseSVF (Function &F){
+  if (this->disableSVF){
+    return false;
+  }
+  if (this->functionsModifiedAfterSVF.find(&F) != this->functionsModifiedAfterSVF.end()){
+    return false;
+  }
+
+  return true;
+}
+
+AliasQueryCache * PDGAnalysis::getAliasQueryCache (void){
+  return &this->aliasQueryCache;
+}
+
+bool PDGAnalysis::hasPDGAsMetadata(Module &M) {
+  auto embeddedPDG = this->fetchEmbeddedPDG(M);
+
+  return !embeddedPDG.empty();
 }
 
 PDG * PDGAnalysis::constructPDGFromAnalysis(Module &M) {
@@ -216,14 +354,28 @@ PDG * PDGAnalysis::constructPDGFromAnalysis(Module &M) {
     errs() << "PDGAnalysis: Construct PDG from Analysis\n";
   }
 
+  /*
+   * The IR might have changed since the cached alias queries were answered (e.g., new instructions or new operands).
+   */
+  this->aliasQueryCache.clear();
+
   auto pdg = new PDG(M);
 
   constructEdgesFromUseDefs(pdg);
-  constructEdgesFromAliases(pdg, M);
-  constructEdgesFromControl(pdg, M);
+  if (this->numberOfThreads > 1){
+    constructEdgesFromAliasesAndControlInParallel(pdg, M);
+  } else {
+    constructEdgesFromAliases(pdg, M);
+    constructEdgesFromControl(pdg, M);
+  }
 
   trimDGUsingCustomAliasAnalysis(pdg);
 
+  if (verbose >= PDGVerbosity::Minimal) {
+    errs() << "PDGAnalysis: Alias queries avoided by partitioning memory instructions = " << this->numberOfAvoidedAliasQueries << "\n";
+    this->aliasQueryCache.printStatistics(errs());
+  }
+
   return pdg; 
 }
 
@@ -253,10 +405,10 @@ PDG * PDGAnalysis::constructPDGFromMetadata(Module &M) {
   /*
    * Fill up the PDG.
    */
-  std::unordered_map<MDNode *, Value *> IDNodeMap;
-  for (auto &F : M) {
-    constructNodesFromMetadata(pdg, F, IDNodeMap);
-    constructEdgesFromMetadata(pdg, F, IDNodeMap);
+  auto embeddedPDG = this->fetchEmbeddedPDG(M);
+  if (!this->constructEdgesFromEmbeddedPDG(pdg, embeddedPDG, nullptr)){
+    delete pdg;
+    return nullptr;
   }
 
   return pdg;
@@ -268,133 +420,13 @@ PDG * PDGAnalysis::constructFunctionDGFromMetadata(Function &F) {
   }
 
   auto pdg = new PDG(F);
-  std::unordered_map<MDNode *, Value *> IDNodeMap;
-  constructNodesFromMetadata(pdg, F, IDNodeMap);
-  constructEdgesFromMetadata(pdg, F, IDNodeMap);
-  return pdg;
-}
-
-void PDGAnalysis::constructNodesFromMetadata(PDG *pdg, Function &F, unordered_map<MDNode *, Value *> &IDNodeMap) {
-
-  /*
-   * Construct id to node map and add nodes of arguments to pdg
-   */
-  if (MDNode *argsM = F.getMetadata("noelle.pdg.args.id")) {
-    for (auto &arg : F.args()) {
-      if (MDNode *m = dyn_cast<MDNode>(argsM->getOperand(arg.getArgNo()))) {
-        IDNodeMap[m] = &arg;
-      }
-    }
-  }
-
-  /*
-   * Construct id to node map and add nodes of instructions to pdg
-   */
-  for (auto &B : F) {
-    for (auto &I : B) {
-      if (MDNode *m = I.getMetadata("noelle.pdg.inst.id")) {
-        IDNodeMap[m] = &I;
-      }
-    }
-  }
-
-  return;
-}
-
-void PDGAnalysis::constructEdgesFromMetadata(PDG *pdg, Function &F, unordered_map<MDNode *, Value *> &IDNodeMap) {
-
-  /*
-   * Construct edges and set attributes
-   */
-  if (MDNode *edgesM = F.getMetadata("noelle.pdg.edges")) {
-    for (auto &operand : edgesM->operands()) {
-      if (MDNode *edgeM = dyn_cast<MDNode>(operand)) {
-        auto edge = constructEdgeFromMetadata(pdg, edgeM, IDNodeMap);
-  
-        /*
-         * Construct subEdges and set attributes
-         */        
-        if (MDNode *subEdgesM = dyn_cast<MDNode>(edgeM->getOperand(8))) {
-          for (auto &subOperand : subEdgesM->operands()) {
-            if (MDNode *subEdgeM = dyn_cast<MDNode>(subOperand)) {
-              DGEdge<Value> *subEdge = constructEdgeFromMetadata(pdg, subEdgeM, IDNodeMap);
-              edge->addSubEdge(subEdge);
-            }
-          }
-        }
-        
-        /*
-         * Add edge to pdg
-         */ 
-        pdg->copyAddEdge(*edge);
-
-        /*
-         * Free the memory.
-         */
-        delete edge;
-      }
-    }
+  auto embeddedPDG = this->fetchEmbeddedPDG(*F.getParent());
+  if (!this->constructEdgesFromEmbeddedPDG(pdg, embeddedPDG, &F)){
+    delete pdg;
+    return nullptr;
   }
 
-  return;
-}
-
-DGEdge<Value> * PDGAnalysis::constructEdgeFromMetadata(PDG *pdg, MDNode *edgeM, unordered_map<MDNode *, Value *> &IDNodeMap) {
-  DGEdge<Value> *edge = nullptr;
-
-  if (MDNode *fromM = dyn_cast<MDNode>(edgeM->getOperand(0))) {
-    if (MDNode *toM = dyn_cast<MDNode>(edgeM->getOperand(1))) {
-      Value *from = IDNodeMap[fromM];
-      Value *to = IDNodeMap[toM];
-      edge = new DGEdge<Value>(pdg->fetchNode(from), pdg->fetchNode(to));
-      edge->setEdgeAttributes(
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(2))->getOperand(0))->getString() == "true",
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(3))->getOperand(0))->getString() == "true",
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(4))->getOperand(0))->getString().str(),
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(5))->getOperand(0))->getString() == "true",
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(6))->getOperand(0))->getString() == "true",
-        cast<MDString>(cast<MDNode>(edgeM->getOperand(7))->getOperand(0))->getString() == "true"
-      );
-    }
-  }
-
-  return edge;
-}
-
-MDNode * PDGAnalysis::getEdgeMetadata(DGEdge<Value> *edge, LLVMContext &C, unordered_map<Value *, MDNode *> &nodeIDMap) {
-  Metadata *edgeM[] = {
-    nodeIDMap[edge->getOutgoingT()],
-    nodeIDMap[edge->getIncomingT()],
-    MDNode::get(C, MDString::get(C, edge->isMemoryDependence() ? "true" : "false")),
-    MDNode::get(C, MDString::get(C, edge->isMustDependence() ? "true" : "false")),
-    MDNode::get(C, MDString::get(C, edge->dataDepToString())),
-    MDNode::get(C, MDString::get(C, edge->isControlDependence() ? "true" : "false")),
-    MDNode::get(C, MDString::get(C, edge->isLoopCarriedDependence() ? "true" : "false")),
-    MDNode::get(C, MDString::get(C, edge->isRemovableDependence() ? "true" : "false")),
-    getSubEdgesMetadata(edge, C, nodeIDMap)
-  };
-
-  return MDNode::get(C, edgeM);
-}
-
-MDNode * PDGAnalysis::getSubEdgesMetadata(DGEdge<Value> *edge, LLVMContext &C, unordered_map<Value *, MDNode *> &nodeIDMap) {
-  vector<Metadata *> subEdgesVec;
-
-  for (auto &subEdge : edge->getSubEdges()) {
-    Metadata *subEdgeM[] = {
-      nodeIDMap[subEdge->getOutgoingT()],
-      nodeIDMap[subEdge->getIncomingT()],
-      MDNode::get(C, MDString::get(C, edge->isMemoryDependence() ? "true" : "false")),
-      MDNode::get(C, MDString::get(C, edge->isMustDependence() ? "true" : "false")),
-      MDNode::get(C, MDString::get(C, edge->dataDepToString())),
-      MDNode::get(C, MDString::get(C, edge->isControlDependence() ? "true" : "false")),
-      MDNode::get(C, MDString::get(C, edge->isLoopCarriedDependence() ? "true" : "false")),
-      MDNode::get(C, MDString::get(C, edge->isRemovableDependence() ? "true" : "false")),
-    };
-    subEdgesVec.push_back(MDNode::get(C, subEdgeM));
-  }
-
-  return MDTuple::get(C, subEdgesVec);
+  return pdg;
 }
 
 void PDGAnalysis::trimDGUsingCustomAliasAnalysis (PDG *pdg) {
@@ -488,11 +520,57 @@ void PDGAnalysis::constructEdgesFromAliases (PDG *pdg, Module &M){
 
 void PDGAnalysis::constructEdgesFromAliasesForFunction (PDG *pdg, Function &F){
 
+  /*
+   * Compute the memory instructions that can execute after each memory instruction.
+   */
+  auto dfr = this->computeReachableMemoryInstructions(F);
+
+  /*
+   * Add the edges to the PDG.
+   */
+  this->constructEdgesFromAliasesForFunction(pdg, F, dfr);
+
+  /*
+   * Free the memory.
+   */
+  delete dfr;
+
+  return ;
+}
+
+void PDGAnalysis::constructEdgesFromAliasesForFunction (PDG *pdg, Function &F, DataFlowResult *dfr){
+
   /*
    * Fetch the alias analysis.
    */
   auto &AA = getAnalysis<AAResultsWrapperPass>(F).getAAResults();
 
+  /*
+   * Group loads and stores by the object they access.
+   * This allows us to skip pairs of instructions that cannot access the same memory.
+   */
+  auto partition = this->partitionMemoryInstructions(F);
+
+  /*
+   * Query the alias analyses for every memory instruction and the ones that can execute after it.
+   */
+  for (auto &B : F) {
+    for (auto &I : B) {
+      if (auto store = dyn_cast<StoreInst>(&I)) {
+        iterateInstForStore(pdg, F, AA, partition, dfr, store);
+      } else if (auto load = dyn_cast<LoadInst>(&I)) {
+        iterateInstForLoad(pdg, F, AA, partition, dfr, load);
+      } else if (auto call = dyn_cast<CallInst>(&I)) {
+        iterateInstForCall(pdg, F, AA, partition, dfr, call);
+      }
+    }
+  }
+
+  return ;
+}
+
+DataFlowResult * PDGAnalysis::computeReachableMemoryInstructions (Function &F){
+
   /*
    * Run the reachable analysis.
    */
@@ -513,34 +591,19 @@ void PDGAnalysis::constructEdgesFromAliasesForFunction (PDG *pdg, Function &F){
   };
   auto dfr = this->disableRA ? this->dfa.getFullSets(&F) : this->dfa.runReachableAnalysis(&F, onlyMemoryInstructionFilter);
 
-  for (auto &B : F) {
-    for (auto &I : B) {
-      if (auto store = dyn_cast<StoreInst>(&I)) {
-        iterateInstForStore(pdg, F, AA, dfr, store);
-      } else if (auto load = dyn_cast<LoadInst>(&I)) {
-        iterateInstForLoad(pdg, F, AA, dfr, load);
-      } else if (auto call = dyn_cast<CallInst>(&I)) {
-        iterateInstForCall(pdg, F, AA, dfr, call);
-      }
-    }
-  }
-
-  /*
-   * Free the memory.
-   */
-  delete dfr;
+  return dfr;
 }
 
-void PDGAnalysis::iterateInstForCall (PDG *pdg, Function &F, AAResults &AA, DataFlowResult *dfr, CallInst *call) {
+void PDGAnalysis::iterateInstForCall (PDG *pdg, Function &F, AAResults &AA, MemoryObjectPartition &partition, DataFlowResult *dfr, CallInst *call) {
 
-  for (auto I : dfr->OUT(call)) {
+  dfr->iterateOverOUT(call, [this, pdg, &F, &AA, call](Value *I) -> bool {
 
     /*
      * Check stores.
      */
     if (auto store = dyn_cast<StoreInst>(I)) {
       addEdgeFromFunctionModRef(pdg, F, AA, call, store, true);
-      continue ;
+      return false;
     }
 
     /*
@@ -548,7 +611,7 @@ void PDGAnalysis::iterateInstForCall (PDG *pdg, Function &F, AAResults &AA, Data
      */
     if (auto load = dyn_cast<LoadInst>(I)) {
       addEdgeFromFunctionModRef(pdg, F, AA, call, load, true);
-      continue ;
+      return false;
     }
 
     /*
@@ -556,9 +619,10 @@ void PDGAnalysis::iterateInstForCall (PDG *pdg, Function &F, AAResults &AA, Data
      */
     if (auto otherCall = dyn_cast<CallInst>(I)) {
       addEdgeFromFunctionModRef(pdg, F, AA, call, otherCall);
-      continue ;
     }
-  }
+
+    return false;
+  });
 
   return ;
 }
@@ -47,59 +47,113 @@ void PDGAnalysis::constructEdgesFromControlForFunction (PDG *pdg, Function &F) {
    */
   auto &postDomTree = getAnalysis<PostDominatorTreeWrapperPass>(F).getPostDomTree();
 
-  for (auto &B : F) {
+  /*
+   * Compute the control dependences and add them to the PDG.
+   */
+  auto controlDependences = this->computeControlDependences(F, postDomTree);
+  this->constructEdgesFromControlForFunction(pdg, F, controlDependences);
 
-    /*
-     * Fetch the basic blocks post-dominated by the current one.
-     */
-    SmallVector<BasicBlock *, 10> dominatedBBs;
-    postDomTree.getDescendants(&B, dominatedBBs);
+  return ;
+}
+
+PDGAnalysis::ControlDependences PDGAnalysis::computeControlDependences (Function &F, PostDominatorTree &postDomTree) {
+
+  /*
+   * A basic block B is control dependent on the terminator of a predecessor predBB of a basic block dominatedBB if B post-dominates dominatedBB, but B does not strictly post-dominate predBB.
+   * The basic blocks that satisfy this condition are the ones we encounter by walking the post-dominator tree from dominatedBB (included) up to the immediate post-dominator of predBB (excluded).
+   * This is how post-dominance frontiers are computed (Cytron et al.), and it takes time linear in the number of control dependences between basic blocks.
+   *
+   * We visit the post-dominator tree in the same order used by PostDominatorTree::getDescendants.
+   * This keeps the order (and the multiplicity) of the control dependences of each basic block equal to the one obtained by visiting the descendants of each basic block.
+   */
+  std::unordered_map<BasicBlock *, std::vector<Instruction *>> controlTerminatorsOfBB;
+  SmallVector<DomTreeNode *, 32> nodesToVisit;
+  nodesToVisit.push_back(postDomTree.getRootNode());
+  while (!nodesToVisit.empty()) {
+    auto node = nodesToVisit.pop_back_val();
+    nodesToVisit.append(node->begin(), node->end());
 
     /*
-     * For each basic block that B post dominates, check if B doesn't stricly post dominate its predecessor
-     * If it does not, then there is a control dependency from the predecessor to B 
+     * Skip the virtual root of the post-dominator tree.
      */
-    for (auto dominatedBB : dominatedBBs) {
-      for (auto predBB : make_range(pred_begin(dominatedBB), pred_end(dominatedBB))) {
-
-        /*
-         * Fetch the terminator of the predecessor.
-         */
-        auto controlTerminator = predBB->getTerminator();
-
-        /*
-         * Check if the predecessor terminator is a conditional branch.
-         * This is necessary to avoid adding incorrect control dependences between basic blocks of a loop that has no exit blocks.
-         * For example:
-         *
-         * predBB:
-         *  branch B
-         *
-         * B: 
-         *  i
-         *  branch %B
-         *
-         * In this case, if we don't check that the terminator of predBB is a conditional branch, we would add a control dependence from branch %B to i
-         */
-        if (controlTerminator->getNumSuccessors() == 1){
-          continue ;
-        }
-
-        /*
-         * Check if B strictly post-dominates predBB.
-         */
-        if (postDomTree.properlyDominates(&B, predBB)) {
-          continue;
-        }
-
-        /*
-         * Add the control dependences.
-         */
-        for (auto &I : B) {
-          auto edge = pdg->addEdge((Value*)controlTerminator, (Value*)&I);
-          edge->setControl(true);
-        }
+    auto dominatedBB = node->getBlock();
+    if (dominatedBB == nullptr) {
+      continue ;
+    }
+
+    for (auto predBB : make_range(pred_begin(dominatedBB), pred_end(dominatedBB))) {
+
+      /*
+       * Fetch the terminator of the predecessor.
+       */
+      auto controlTerminator = predBB->getTerminator();
+
+      /*
+       * Check if the predecessor terminator is a conditional branch.
+       * This is necessary to avoid adding incorrect control dependences between basic blocks of a loop that has no exit blocks.
+       * For example:
+       *
+       * predBB:
+       *  branch B
+       *
+       * B: 
+       *  i
+       *  branch %B
+       *
+       * In this case, if we don't check that the terminator of predBB is a conditional branch, we would add a control dependence from branch %B to i
+       */
+      if (controlTerminator->getNumSuccessors() == 1){
+        continue ;
       }
+
+      /*
+       * Basic blocks that are not part of the post-dominator tree are strictly post-dominated by every basic block.
+       */
+      auto predNode = postDomTree.getNode(predBB);
+      if (predNode == nullptr) {
+        continue ;
+      }
+
+      /*
+       * Add the control dependences to the basic blocks that post-dominate dominatedBB without strictly post-dominating predBB.
+       */
+      auto immediatePostDominatorOfPred = predNode->getIDom();
+      for (auto runner = node; (runner != immediatePostDominatorOfPred) && (runner->getBlock() != nullptr); runner = runner->getIDom()) {
+        controlTerminatorsOfBB[runner->getBlock()].push_back(controlTerminator);
+      }
+    }
+  }
+
+  /*
+   * Collect the control dependences following the order of the basic blocks in the function.
+   */
+  ControlDependences controlDependences;
+  for (auto &B : F) {
+    auto controlTerminatorsIt = controlTerminatorsOfBB.find(&B);
+    if (controlTerminatorsIt == controlTerminatorsOfBB.end()) {
+      continue ;
+    }
+    for (auto controlTerminator : controlTerminatorsIt->second) {
+      controlDependences.push_back(std::make_pair(controlTerminator, &B));
+    }
+  }
+
+  return controlDependences;
+}
+
+void PDGAnalysis::constructEdgesFromControlForFunction (PDG *pdg, Function &F, ControlDependences &controlDependences) {
+  assert(pdg != nullptr);
+
+  /*
+   * Add the control dependences computed from the post-dominator tree.
+   * Each of them is expanded to all instructions of the dependent basic block.
+   */
+  for (auto &dependence : controlDependences) {
+    auto controlTerminator = dependence.first;
+    auto dependentBB = dependence.second;
+    for (auto &I : *dependentBB) {
+      auto edge = pdg->addEdge((Value*)controlTerminator, (Value*)&I);
+      edge->setControl(true);
     }
   }
 
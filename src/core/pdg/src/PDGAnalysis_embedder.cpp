@@ -18,80 +18,541 @@
 
 using namespace llvm;
 
-void PDGAnalysis::embedPDGAsMetadata(PDG *pdg) {
-  errs() << "Embed PDG as Metadata\n";
 
-  auto &C = this->M->getContext();
-  unordered_map<Value *, MDNode *> nodeIDMap;
+/*
+ * The PDG is embedded in the IR as a single binary blob: the string operand of the named metadata "noelle.module.pdg".
+ *
+ * Layout (integers are unsigned LEB128 unless noted otherwise):
+ *   "NPDG", version (1 byte), number of functions with a body
+ *   per function, in module order: number of nodes, signature of the body (8 bytes, little endian), size in bytes of its edges
+ *   per function, in module order: its edges
+ *
+ * Node IDs are not stored: they are the positions of the arguments and then the instructions of each function, in module order.
+ * The edges of a function are the ones whose source belongs to it, sorted by source.
+ * An edge is encoded as the delta of its source from the previous source, the zigzag delta of its destination from its source, and its attributes (1 byte).
+ * If the attributes say so, the sub-edges follow: their number and then, for each one, the zigzag deltas of its source from the source of the edge and of its destination from its own source, and its attributes.
+ */
+namespace {
 
-  embedNodesAsMetadata(pdg, C, nodeIDMap);
-  embedEdgesAsMetadata(pdg, C, nodeIDMap);
+  const char embeddedPDGMagic[] = "NPDG";
+  const uint8_t embeddedPDGVersion = 2;
 
-  auto n = this->M->getOrInsertNamedMetadata("noelle.module.pdg");
-  n->addOperand(MDNode::get(C, MDString::get(C, "true")));
+  enum EmbeddedEdgeAttribute : uint8_t {
+    EMBEDDED_EDGE_MEMORY = 1 << 0,
+    EMBEDDED_EDGE_MUST = 1 << 1,
+    EMBEDDED_EDGE_CONTROL = 1 << 2,
+    EMBEDDED_EDGE_LOOP_CARRIED = 1 << 3,
+    EMBEDDED_EDGE_REMOVABLE = 1 << 4,
+    EMBEDDED_EDGE_DATA_SHIFT = 5,
+    EMBEDDED_EDGE_HAS_SUB_EDGES = 1 << 7
+  };
+
+  void writeVarint (std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back((char)((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back((char)value);
+
+    return ;
+  }
+
+  void writeSignedVarint (std::string &out, int64_t value) {
+    writeVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+
+    return ;
+  }
+
+  void writeFixed64 (std::string &out, uint64_t value) {
+    for (auto i = 0; i < 8; i++) {
+      out.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+
+    return ;
+  }
+
+  uint8_t encodeEdgeAttributes (DGEdge<Value> *edge, bool hasSubEdges) {
+    uint8_t attributes = 0;
+    if (edge->isMemoryDependence())       attributes |= EMBEDDED_EDGE_MEMORY;
+    if (edge->isMustDependence())         attributes |= EMBEDDED_EDGE_MUST;
+    if (edge->isControlDependence())      attributes |= EMBEDDED_EDGE_CONTROL;
+    if (edge->isLoopCarriedDependence())  attributes |= EMBEDDED_EDGE_LOOP_CARRIED;
+    if (edge->isRemovableDependence())    attributes |= EMBEDDED_EDGE_REMOVABLE;
+    if (hasSubEdges)                      attributes |= EMBEDDED_EDGE_HAS_SUB_EDGES;
+    attributes |= (uint8_t)(edge->dataDependenceType() << EMBEDDED_EDGE_DATA_SHIFT);
+
+    return attributes;
+  }
+
+  void decodeEdgeAttributes (DGEdge<Value> *edge, uint8_t attributes) {
+    auto dataDependenceType = (DataDependenceType)((attributes >> EMBEDDED_EDGE_DATA_SHIFT) & 0x3);
+    edge->setMemMustType((attributes & EMBEDDED_EDGE_MEMORY) != 0, (attributes & EMBEDDED_EDGE_MUST) != 0, dataDependenceType);
+    edge->setControl((attributes & EMBEDDED_EDGE_CONTROL) != 0);
+    edge->setLoopCarried((attributes & EMBEDDED_EDGE_LOOP_CARRIED) != 0);
+    edge->setRemovable((attributes & EMBEDDED_EDGE_REMOVABLE) != 0);
+
+    return ;
+  }
+
+  /*
+   * Append the nodes of a function (arguments first, then instructions) and return the signature of its body.
+   * The signature is used to detect an embedded PDG that no longer matches the IR.
+   *
+   * The signature covers the opcode, the type, the predicate (for comparisons), and the operands of every instruction.
+   * Operands that belong to the function (arguments, basic blocks, and instructions) are identified by their position within it.
+   * The other operands are identified by their content (e.g., the name of a global, the value of a constant).
+   */
+  uint64_t collectNodesOf (Function &F, std::vector<Value *> &nodes) {
+    uint64_t signature = 14695981039346656037ULL;
+    auto hash = [&signature](uint64_t value) -> void {
+      signature ^= value;
+      signature *= 1099511628211ULL;
+    };
+    auto hashString = [&hash](StringRef string) -> void {
+      hash(string.size());
+      for (auto c : string) {
+        hash((uint8_t)c);
+      }
+    };
+    auto hashAPInt = [&hash](const APInt &value) -> void {
+      hash(value.getBitWidth());
+      for (auto i = 0u; i < value.getNumWords(); i++) {
+        hash(value.getRawData()[i]);
+      }
+    };
+
+    /*
+     * Assign a position to the values that belong to the function.
+     */
+    std::unordered_map<Value *, uint64_t> localIDs;
+    uint64_t nextLocalID = 0;
+    for (auto &arg : F.args()) {
+      localIDs[&arg] = nextLocalID++;
+      nodes.push_back(&arg);
+    }
+    for (auto &B : F) {
+      localIDs[&B] = nextLocalID++;
+      for (auto &I : B) {
+        localIDs[&I] = nextLocalID++;
+        nodes.push_back(&I);
+      }
+    }
+
+    /*
+     * Hash the body.
+     */
+    hash(F.arg_size());
+    for (auto &B : F) {
+      hash(B.size());
+      for (auto &I : B) {
+        hash(I.getOpcode());
+        hash(I.getType()->getTypeID());
+        if (auto cmpInst = dyn_cast<CmpInst>(&I)) {
+          hash(cmpInst->getPredicate());
+        }
+        hash(I.getNumOperands());
+        for (auto &operand : I.operands()) {
+          auto value = operand.get();
+          auto localID = localIDs.find(value);
+          if (localID != localIDs.end()) {
+            hash(localID->second);
+            continue ;
+          }
+          hash(value->getValueID());
+          if (auto global = dyn_cast<GlobalValue>(value)) {
+            hashString(global->getName());
+          } else if (auto constantInt = dyn_cast<ConstantInt>(value)) {
+            hashAPInt(constantInt->getValue());
+          } else if (auto constantFP = dyn_cast<ConstantFP>(value)) {
+            hashAPInt(constantFP->getValueAPF().bitcastToAPInt());
+          } else if (  false
+                       || isa<ConstantPointerNull>(value)
+                       || isa<UndefValue>(value)
+                       || isa<ConstantAggregateZero>(value)
+            ){
+            hash(value->getType()->getTypeID());
+          } else {
+
+            /*
+             * Constant expressions, other constants, metadata, and inline assembly are identified by their textual form.
+             */
+            std::string valueAsString;
+            raw_string_ostream stream(valueAsString);
+            value->printAsOperand(stream, true, F.getParent());
+            hashString(stream.str());
+          }
+        }
+      }
+    }
+
+    return signature;
+  }
+
+  /*
+   * Bounds-checked reader of the blob.
+   */
+  class EmbeddedPDGReader {
+    public:
+      EmbeddedPDGReader (StringRef bytes)
+        : current{(const uint8_t *)bytes.begin()}, end{(const uint8_t *)bytes.end()}, failed{false}
+        {}
+
+      uint64_t readVarint (void) {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+          if (current == end) {
+            break ;
+          }
+          auto byte = *(current++);
+          value |= ((uint64_t)(byte & 0x7F)) << shift;
+          if ((byte & 0x80) == 0) {
+            return value;
+          }
+        }
+        failed = true;
+        return 0;
+      }
+
+      int64_t readSignedVarint (void) {
+        auto value = this->readVarint();
+        return (int64_t)(value >> 1) ^ -((int64_t)(value & 1));
+      }
+
+      uint64_t readFixed64 (void) {
+        if ((end - current) < 8) {
+          failed = true;
+          return 0;
+        }
+        uint64_t value = 0;
+        for (auto i = 0; i < 8; i++) {
+          value |= ((uint64_t)current[i]) << (8 * i);
+        }
+        current += 8;
+        return value;
+      }
+
+      uint8_t readByte (void) {
+        if (current == end) {
+          failed = true;
+          return 0;
+        }
+        return *(current++);
+      }
+
+      EmbeddedPDGReader readBytes (uint64_t size) {
+        if ((uint64_t)(end - current) < size) {
+          failed = true;
+          size = end - current;
+        }
+        auto bytes = StringRef((const char *)current, size);
+        current += size;
+        return EmbeddedPDGReader(bytes);
+      }
+
+      bool isAtEnd (void) const { return current == end; }
+
+      bool hasFailed (void) const { return failed; }
+
+    private:
+      const uint8_t *current;
+      const uint8_t *end;
+      bool failed;
+  };
 
-  return;
 }
 
-void PDGAnalysis::embedNodesAsMetadata(PDG *pdg, LLVMContext &C, unordered_map<Value *, MDNode *> &nodeIDMap) {
-  uint64_t i = 0;
-  unordered_map<Function *, unordered_map<uint64_t, Metadata *>> functionArgsIDMap;
+void PDGAnalysis::embedPDGAsMetadata(PDG *pdg) {
+  errs() << "Embed PDG as Metadata\n";
 
   /*
-   * Construct node to id map and embed metadata of instruction nodes to instruction
+   * Assign an ID to every node.
    */
-  for (auto &node : pdg->getNodes()) {
-    Value *v = node->getT();
-    Constant *id = ConstantInt::get(Type::getInt64Ty(C), i++);
-    MDNode *m = MDNode::get(C, ConstantAsMetadata::get(id));
-    if (Argument *arg = dyn_cast<Argument>(v)) {
-      functionArgsIDMap[arg->getParent()][arg->getArgNo()] = m;
+  std::vector<Value *> nodes;
+  std::vector<uint64_t> signatures;
+  std::vector<uint64_t> firstNodeOfFunction;
+  for (auto &F : *this->M) {
+    if (F.isDeclaration()) {
+      continue ;
     }
-    else if (Instruction *inst = dyn_cast<Instruction>(v)) {
-      inst->setMetadata("noelle.pdg.inst.id", m);
+    firstNodeOfFunction.push_back(nodes.size());
+    signatures.push_back(collectNodesOf(F, nodes));
+  }
+  firstNodeOfFunction.push_back(nodes.size());
+  std::unordered_map<Value *, uint64_t> nodeIDs;
+  nodeIDs.reserve(nodes.size());
+  for (uint64_t i = 0; i < nodes.size(); i++) {
+    nodeIDs[nodes[i]] = i;
+  }
+
+  /*
+   * Group the edges by the function of their source.
+   */
+  auto numberOfFunctions = signatures.size();
+  std::vector<std::vector<std::pair<uint64_t, DGEdge<Value> *>>> edgesOfFunction(numberOfFunctions);
+  for (auto edge : pdg->getEdges()) {
+    auto sourceID = nodeIDs.find(edge->getOutgoingT());
+    if (  false
+          || (sourceID == nodeIDs.end())
+          || (nodeIDs.find(edge->getIncomingT()) == nodeIDs.end())
+      ){
+      continue ;
     }
-    nodeIDMap[v] = m;
+    auto functionIndex = std::upper_bound(firstNodeOfFunction.begin(), firstNodeOfFunction.end(), sourceID->second) - firstNodeOfFunction.begin() - 1;
+    edgesOfFunction[functionIndex].push_back(std::make_pair(sourceID->second, edge));
   }
 
   /*
-   * Embed metadta of argument nodes to function
+   * Encode the edges of each function.
    */
-  for (auto &funArgs : functionArgsIDMap) {
-    vector<Metadata *> argsVec;
-    for (uint64_t i = 0; i < funArgs.second.size(); i++) {
-      argsVec.push_back(funArgs.second[i]);
+  std::vector<std::string> encodedEdgesOfFunction(numberOfFunctions);
+  for (auto functionIndex = 0; functionIndex < numberOfFunctions; functionIndex++) {
+    auto &edges = edgesOfFunction[functionIndex];
+    auto &out = encodedEdgesOfFunction[functionIndex];
+    std::stable_sort(edges.begin(), edges.end(), [](auto &edge1, auto &edge2) -> bool {
+      return edge1.first < edge2.first;
+    });
+
+    writeVarint(out, edges.size());
+    uint64_t previousSourceID = firstNodeOfFunction[functionIndex];
+    for (auto &sourceAndEdge : edges) {
+      auto sourceID = sourceAndEdge.first;
+      auto edge = sourceAndEdge.second;
+      auto destinationID = nodeIDs[edge->getIncomingT()];
+
+      std::vector<std::pair<uint64_t, DGEdge<Value> *>> subEdges;
+      for (auto subEdge : edge->getSubEdges()) {
+        auto subSourceID = nodeIDs.find(subEdge->getOutgoingT());
+        if (  false
+              || (subSourceID == nodeIDs.end())
+              || (nodeIDs.find(subEdge->getIncomingT()) == nodeIDs.end())
+          ){
+          continue ;
+        }
+        subEdges.push_back(std::make_pair(subSourceID->second, subEdge));
+      }
+
+      writeVarint(out, sourceID - previousSourceID);
+      writeSignedVarint(out, (int64_t)destinationID - (int64_t)sourceID);
+      out.push_back((char)encodeEdgeAttributes(edge, !subEdges.empty()));
+      previousSourceID = sourceID;
+
+      if (subEdges.empty()) {
+        continue ;
+      }
+      writeVarint(out, subEdges.size());
+      for (auto &subSourceAndEdge : subEdges) {
+        auto subSourceID = subSourceAndEdge.first;
+        auto subEdge = subSourceAndEdge.second;
+        auto subDestinationID = nodeIDs[subEdge->getIncomingT()];
+        writeSignedVarint(out, (int64_t)subSourceID - (int64_t)sourceID);
+        writeSignedVarint(out, (int64_t)subDestinationID - (int64_t)subSourceID);
+        out.push_back((char)encodeEdgeAttributes(subEdge, false));
+      }
     }
+  }
 
-    MDNode *m = MDTuple::get(C, argsVec);
-    funArgs.first->setMetadata("noelle.pdg.args.id", m);
+  /*
+   * Assemble the blob.
+   */
+  std::string blob{embeddedPDGMagic};
+  blob.push_back((char)embeddedPDGVersion);
+  writeVarint(blob, numberOfFunctions);
+  for (auto functionIndex = 0; functionIndex < numberOfFunctions; functionIndex++) {
+    writeVarint(blob, firstNodeOfFunction[functionIndex + 1] - firstNodeOfFunction[functionIndex]);
+    writeFixed64(blob, signatures[functionIndex]);
+    writeVarint(blob, encodedEdgesOfFunction[functionIndex].size());
+  }
+  for (auto &encodedEdges : encodedEdgesOfFunction) {
+    blob.append(encodedEdges);
   }
 
+  /*
+   * Embed the blob, replacing the PDG embedded before (if any).
+   */
+  auto &C = this->M->getContext();
+  auto n = this->M->getOrInsertNamedMetadata("noelle.module.pdg");
+  n->clearOperands();
+  n->addOperand(MDNode::get(C, MDString::get(C, blob)));
+
   return;
 }
 
-void PDGAnalysis::embedEdgesAsMetadata(PDG *pdg, LLVMContext &C, unordered_map<Value *, MDNode *> &nodeIDMap) {
-  unordered_map<Function *, vector<Metadata *>> functionEdgesMap;
+StringRef PDGAnalysis::fetchEmbeddedPDG(Module &M) {
+  auto n = M.getNamedMetadata("noelle.module.pdg");
+  if (  false
+        || (n == nullptr)
+        || (n->getNumOperands() != 1)
+        || (n->getOperand(0)->getNumOperands() != 1)
+    ){
+    return StringRef();
+  }
+  auto blobM = dyn_cast<MDString>(n->getOperand(0)->getOperand(0));
+  if (blobM == nullptr) {
+    return StringRef();
+  }
+
+  /*
+   * Check the header.
+   */
+  auto blob = blobM->getString();
+  auto magicSize = sizeof(embeddedPDGMagic) - 1;
+  if (  false
+        || (blob.size() <= magicSize)
+        || (!blob.startswith(embeddedPDGMagic))
+        || ((uint8_t)blob[magicSize] != embeddedPDGVersion)
+    ){
+    return StringRef();
+  }
+
+  return blob;
+}
+
+bool PDGAnalysis::constructEdgesFromEmbeddedPDG(PDG *pdg, StringRef embeddedPDG, Function *onlyFunction) {
 
   /*
-   * Construct edge metadata
+   * Read the table of the functions.
    */
-  for (auto &edge : pdg->getEdges()) {
-    MDNode *edgeM = getEdgeMetadata(edge, C, nodeIDMap);
-    if (Argument *arg = dyn_cast<Argument>(edge->getOutgoingT())) {
-      functionEdgesMap[arg->getParent()].push_back(edgeM);
+  auto headerSize = (sizeof(embeddedPDGMagic) - 1) + sizeof(embeddedPDGVersion);
+  EmbeddedPDGReader reader(embeddedPDG.drop_front(headerSize));
+  std::vector<Function *> functions;
+  for (auto &F : *this->M) {
+    if (F.isDeclaration()) {
+      continue ;
     }
-    else if (Instruction *inst = dyn_cast<Instruction>(edge->getOutgoingT())) {
-      functionEdgesMap[inst->getFunction()].push_back(edgeM);
+    functions.push_back(&F);
+  }
+  auto numberOfFunctions = reader.readVarint();
+  if (numberOfFunctions != functions.size()) {
+    errs() << "PDGAnalysis: The embedded PDG does not match the IR\n";
+    return false;
+  }
+  std::vector<uint64_t> numberOfNodes(numberOfFunctions);
+  std::vector<uint64_t> signatures(numberOfFunctions);
+  std::vector<uint64_t> sizes(numberOfFunctions);
+  for (auto functionIndex = 0; functionIndex < numberOfFunctions; functionIndex++) {
+    numberOfNodes[functionIndex] = reader.readVarint();
+    signatures[functionIndex] = reader.readFixed64();
+    sizes[functionIndex] = reader.readVarint();
+  }
+  if (reader.hasFailed()) {
+    errs() << "PDGAnalysis: The embedded PDG is malformed\n";
+    return false;
+  }
+
+  /*
+   * Map the IDs of the nodes we need to their values.
+   * The signature of a function must match the one of its embedded edges.
+   */
+  uint64_t totalNodes = 0;
+  for (auto nodes : numberOfNodes) {
+    totalNodes += nodes;
+  }
+  std::vector<Value *> nodes;
+  nodes.reserve(totalNodes);
+  for (auto functionIndex = 0; functionIndex < numberOfFunctions; functionIndex++) {
+    auto F = functions[functionIndex];
+    auto firstNode = nodes.size();
+    if (  (onlyFunction != nullptr)
+          && (F != onlyFunction)
+      ){
+      nodes.resize(firstNode + numberOfNodes[functionIndex], nullptr);
+      continue ;
+    }
+    auto signature = collectNodesOf(*F, nodes);
+    if (  false
+          || (signature != signatures[functionIndex])
+          || ((nodes.size() - firstNode) != numberOfNodes[functionIndex])
+      ){
+      errs() << "PDGAnalysis: The embedded PDG does not match the function " << F->getName() << "\n";
+      return false;
     }
   }
 
   /*
-   * Embed metadata of edges to function
+   * Add the edges.
    */
-  for (auto &funEdge : functionEdgesMap) {
-    MDNode *m = MDTuple::get(C, funEdge.second);
-    funEdge.first->setMetadata("noelle.pdg.edges", m);
+  uint64_t firstNode = 0;
+  for (auto functionIndex = 0; functionIndex < numberOfFunctions; functionIndex++) {
+    auto edgesReader = reader.readBytes(sizes[functionIndex]);
+    auto firstNodeOfFunction = firstNode;
+    firstNode += numberOfNodes[functionIndex];
+    if (  (onlyFunction != nullptr)
+          && (functions[functionIndex] != onlyFunction)
+      ){
+      continue ;
+    }
+
+    auto fetchValue = [&nodes, pdg](int64_t nodeID) -> Value * {
+      if (  false
+            || (nodeID < 0)
+            || ((uint64_t)nodeID >= nodes.size())
+        ){
+        return nullptr;
+      }
+      auto value = nodes[nodeID];
+      if (  (value == nullptr)
+            || (!pdg->isInGraph(value))
+        ){
+        return nullptr;
+      }
+      return value;
+    };
+
+    auto numberOfEdges = edgesReader.readVarint();
+    int64_t sourceID = firstNodeOfFunction;
+    for (uint64_t i = 0; i < numberOfEdges; i++) {
+      sourceID += edgesReader.readVarint();
+      auto destinationID = sourceID + edgesReader.readSignedVarint();
+      auto attributes = edgesReader.readByte();
+
+      /*
+       * Read the sub-edges.
+       */
+      std::vector<DGEdge<Value> *> subEdges;
+      if (attributes & EMBEDDED_EDGE_HAS_SUB_EDGES) {
+        auto numberOfSubEdges = edgesReader.readVarint();
+        for (uint64_t j = 0; j < numberOfSubEdges; j++) {
+          auto subSourceID = sourceID + edgesReader.readSignedVarint();
+          auto subDestinationID = subSourceID + edgesReader.readSignedVarint();
+          auto subAttributes = edgesReader.readByte();
+          auto subSource = fetchValue(subSourceID);
+          auto subDestination = fetchValue(subDestinationID);
+          if (  (subSource == nullptr)
+                || (subDestination == nullptr)
+            ){
+            continue ;
+          }
+          auto subEdge = new DGEdge<Value>(pdg->fetchNode(subSource), pdg->fetchNode(subDestination));
+          decodeEdgeAttributes(subEdge, subAttributes);
+          subEdges.push_back(subEdge);
+        }
+      }
+      if (edgesReader.hasFailed()) {
+        errs() << "PDGAnalysis: The embedded PDG is malformed\n";
+        return false;
+      }
+
+      /*
+       * Add the edge.
+       * Its attributes are set after its sub-edges are added because adding them changes the attributes of the edge.
+       */
+      auto source = fetchValue(sourceID);
+      auto destination = fetchValue(destinationID);
+      if (  (source == nullptr)
+            || (destination == nullptr)
+        ){
+        for (auto subEdge : subEdges) {
+          delete subEdge;
+        }
+        continue ;
+      }
+      auto edge = pdg->addEdge(source, destination);
+      for (auto subEdge : subEdges) {
+        edge->addSubEdge(subEdge);
+      }
+      decodeEdgeAttributes(edge, attributes);
+    }
   }
 
-  return;
+  return true;
 }
@@ -9,6 +9,7 @@
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "SystemHeaders.hpp"
+#include "llvm/Analysis/ValueTracking.h"
 
 #include "Util/SVFModule.h"
 #include "WPA/Andersen.h"
@@ -18,26 +19,88 @@
 
 using namespace llvm;
 
-void PDGAnalysis::iterateInstForStore (PDG *pdg, Function &F, AAResults &AA, DataFlowResult *dfr, StoreInst *store) {
+PDGAnalysis::MemoryObjectPartition PDGAnalysis::partitionMemoryInstructions (Function &F) {
+  MemoryObjectPartition partition;
 
-  for (auto I : dfr->OUT(store)) {
+  /*
+   * Fetch the object accessed by each load and store.
+   *
+   * We only keep identified objects (e.g., allocas, globals, noalias calls).
+   * Two accesses to different identified objects never alias and BasicAA, which is always the first alias analysis queried, answers NoAlias for them.
+   * Hence, skipping such pairs does not change the PDG.
+   * To guarantee this, the object is computed as BasicAA does.
+   */
+  auto &DL = F.getParent()->getDataLayout();
+  for (auto &I : instructions(F)) {
+    auto inst = &I;
+    Value *pointer = nullptr;
+    if (auto store = dyn_cast<StoreInst>(inst)) {
+      pointer = store->getPointerOperand();
+    } else if (auto load = dyn_cast<LoadInst>(inst)) {
+      pointer = load->getPointerOperand();
+    } else {
+      continue ;
+    }
+    auto object = GetUnderlyingObject(pointer->stripPointerCastsAndInvariantGroups(), DL);
+    if (!isIdentifiedObject(object)) {
+      continue ;
+    }
+    partition[inst] = object;
+  }
+
+  return partition;
+}
+
+bool PDGAnalysis::canAccessTheSameObject (MemoryObjectPartition &partition, Instruction *i, Instruction *j) {
+
+  /*
+   * Check if both instructions access known objects.
+   */
+  auto objectOfI = partition.find(i);
+  if (objectOfI == partition.end()) {
+    return true;
+  }
+  auto objectOfJ = partition.find(j);
+  if (objectOfJ == partition.end()) {
+    return true;
+  }
+
+  /*
+   * Check if the objects are the same.
+   */
+  if (objectOfI->second == objectOfJ->second) {
+    return true;
+  }
+  this->numberOfAvoidedAliasQueries++;
+
+  return false;
+}
+
+void PDGAnalysis::iterateInstForStore (PDG *pdg, Function &F, AAResults &AA, MemoryObjectPartition &partition, DataFlowResult *dfr, StoreInst *store) {
+
+  dfr->iterateOverOUT(store, [this, pdg, &F, &AA, &partition, store](Value *I) -> bool {
 
     /*
      * Check stores.
      */
     if (auto otherStore = dyn_cast<StoreInst>(I)) {
-      if (store != otherStore) {
+      if (  true
+            && (store != otherStore)
+            && canAccessTheSameObject(partition, store, otherStore)
+        ) {
         addEdgeFromMemoryAlias<StoreInst, StoreInst>(pdg, F, AA, store, otherStore, DG_DATA_WAW);
       }
-      continue ;
+      return false;
     }
 
     /* 
      * Check loads.
      */
     if (auto load = dyn_cast<LoadInst>(I)) {
-      addEdgeFromMemoryAlias<StoreInst, LoadInst>(pdg, F, AA, store, load, DG_DATA_RAW);
-      continue ;
+      if (canAccessTheSameObject(partition, store, load)) {
+        addEdgeFromMemoryAlias<StoreInst, LoadInst>(pdg, F, AA, store, load, DG_DATA_RAW);
+      }
+      return false;
     }
 
     /*
@@ -45,23 +108,26 @@ void PDGAnalysis::iterateInstForStore (PDG *pdg, Function &F, AAResults &AA, Dat
      */
     if (auto call = dyn_cast<CallInst>(I)) {
       addEdgeFromFunctionModRef(pdg, F, AA, call, store, false);
-      continue ;
     }
-  }
+
+    return false;
+  });
 
   return ;
 }
 
-void PDGAnalysis::iterateInstForLoad (PDG *pdg, Function &F, AAResults &AA, DataFlowResult *dfr, LoadInst *load) {
+void PDGAnalysis::iterateInstForLoad (PDG *pdg, Function &F, AAResults &AA, MemoryObjectPartition &partition, DataFlowResult *dfr, LoadInst *load) {
 
-  for (auto I : dfr->OUT(load)) {
+  dfr->iterateOverOUT(load, [this, pdg, &F, &AA, &partition, load](Value *I) -> bool {
 
     /*
      * Check stores.
      */
     if (auto store = dyn_cast<StoreInst>(I)) {
-      addEdgeFromMemoryAlias<LoadInst, StoreInst>(pdg, F, AA, load, store, DG_DATA_WAR);
-      continue ;
+      if (canAccessTheSameObject(partition, load, store)) {
+        addEdgeFromMemoryAlias<LoadInst, StoreInst>(pdg, F, AA, load, store, DG_DATA_WAR);
+      }
+      return false;
     }
 
     /*
@@ -69,9 +135,10 @@ void PDGAnalysis::iterateInstForLoad (PDG *pdg, Function &F, AAResults &AA, Data
      */
     if (auto call = dyn_cast<CallInst>(I)) {
       addEdgeFromFunctionModRef(pdg, F, AA, call, load, false);
-      continue ;
     }
-  }
+
+    return false;
+  });
 
   return ;
 }
@@ -103,7 +170,11 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
   /*
    * Query the LLVM alias analyses.
    */
-  switch (AA.getModRefInfo(call, MemoryLocation::get(store))) {
+  auto location = MemoryLocation::get(store);
+  auto llvmModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::LLVM_MODREF, call, location, [&AA, call, &location](void) {
+    return AA.getModRefInfo(call, location);
+  });
+  switch (llvmModRef) {
     case ModRefInfo::NoModRef:
       return;
     case ModRefInfo::Ref:
@@ -122,10 +193,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
    *
    * Check if SVF is enabled.
    */
-  if (this->disableSVF){
+  if (!this->canUseSVF(F)){
 
     /*
-     * SVF is disabled.
+     * SVF is disabled or it has been computed before @F was modified.
      */
 
   } else {
@@ -137,7 +208,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
      * This is due to a bug in SVF that doesn't model I/O library calls correctly.
      */
     if (isSafeToQueryModRefOfSVF(call, bv)) {
-      switch (this->mssa->getMRGenerator()->getModRefInfo(call, MemoryLocation::get(store))) {
+      auto svfModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::SVF_MODREF, call, location, [this, call, &location](void) {
+        return this->mssa->getMRGenerator()->getModRefInfo(call, location);
+      });
+      switch (svfModRef) {
         case ModRefInfo::NoModRef:
           return;
         case ModRefInfo::Ref:
@@ -194,7 +268,11 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
   /*
    * Query the LLVM alias analyses.
    */
-  switch (AA.getModRefInfo(call, MemoryLocation::get(load))) {
+  auto location = MemoryLocation::get(load);
+  auto llvmModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::LLVM_MODREF, call, location, [&AA, call, &location](void) {
+    return AA.getModRefInfo(call, location);
+  });
+  switch (llvmModRef) {
     case ModRefInfo::NoModRef:
     case ModRefInfo::Ref:
       return;
@@ -208,10 +286,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
    *
    * Check if SVF is enabled.
    */
-  if (this->disableSVF){
+  if (!this->canUseSVF(F)){
 
     /*
-     * SVF is disabled.
+     * SVF is disabled or it has been computed before @F was modified.
      */
 
   } else {
@@ -223,7 +301,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
      * This is due to a bug in SVF that doesn't model I/O library calls correctly.
      */
     if (isSafeToQueryModRefOfSVF(call, bv)) {
-      switch (this->mssa->getMRGenerator()->getModRefInfo(call, MemoryLocation::get(load))) {
+      auto svfModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::SVF_MODREF, call, location, [this, call, &location](void) {
+        return this->mssa->getMRGenerator()->getModRefInfo(call, location);
+      });
+      switch (svfModRef) {
         case ModRefInfo::NoModRef:
         case ModRefInfo::Ref:
           return;
@@ -256,7 +337,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
   /*
    * Query the LLVM alias analyses.
    */
-  switch (AA.getModRefInfo(call, otherCall)) {
+  auto llvmModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::LLVM_MODREF, call, otherCall, [&AA, call, otherCall](void) {
+    return AA.getModRefInfo(call, otherCall);
+  });
+  switch (llvmModRef) {
     case ModRefInfo::NoModRef:
       return;
     case ModRefInfo::Ref:
@@ -264,7 +348,9 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
       break;
     case ModRefInfo::Mod:
       bv[1] = true;
-      switch (AA.getModRefInfo(otherCall, call)) {
+      switch (this->aliasQueryCache.getModRefInfo(AliasQueryCache::LLVM_MODREF, otherCall, call, [&AA, call, otherCall](void) {
+          return AA.getModRefInfo(otherCall, call);
+        })) {
         case ModRefInfo::NoModRef:
           return;
         case ModRefInfo::Ref:
@@ -288,10 +374,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
    *
    * Check if SVF is enabled.
    */
-  if (this->disableSVF){
+  if (!this->canUseSVF(F)){
 
     /*
-     * SVF is disabled.
+     * SVF is disabled or it has been computed before @F was modified.
      */
 
   } else {
@@ -311,7 +397,10 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
           && isSafeToQueryModRefOfSVF(call, bv) 
           && isSafeToQueryModRefOfSVF(otherCall, bv)
       ) {
-      switch (this->mssa->getMRGenerator()->getModRefInfo(call, otherCall)) {
+      auto svfModRef = this->aliasQueryCache.getModRefInfo(AliasQueryCache::SVF_MODREF, call, otherCall, [this, call, otherCall](void) {
+        return this->mssa->getMRGenerator()->getModRefInfo(call, otherCall);
+      });
+      switch (svfModRef) {
         case ModRefInfo::NoModRef:
           return;
         case ModRefInfo::Ref:
@@ -319,7 +408,9 @@ void PDGAnalysis::addEdgeFromFunctionModRef (PDG *pdg, Function &F, AAResults &A
           break;
         case ModRefInfo::Mod:
           bv[1] = true;
-          switch (this->mssa->getMRGenerator()->getModRefInfo(otherCall, call)) {
+          switch (this->aliasQueryCache.getModRefInfo(AliasQueryCache::SVF_MODREF, otherCall, call, [this, call, otherCall](void) {
+              return this->mssa->getMRGenerator()->getModRefInfo(otherCall, call);
+            })) {
             case ModRefInfo::NoModRef:
               return;
             case ModRefInfo::Ref:
@@ -437,7 +528,12 @@ void PDGAnalysis::addEdgeFromMemoryAlias (PDG *pdg, Function &F, AAResults &AA,
   /*
    * Query the LLVM alias analyses.
    */
-  switch (AA.alias(MemoryLocation::get(instI), MemoryLocation::get(instJ))) {
+  auto locationI = MemoryLocation::get(instI);
+  auto locationJ = MemoryLocation::get(instJ);
+  auto llvmAlias = this->aliasQueryCache.alias(AliasQueryCache::LLVM_ALIAS, locationI, locationJ, [&AA, &locationI, &locationJ](void) {
+    return AA.alias(locationI, locationJ);
+  });
+  switch (llvmAlias) {
     case NoAlias:
       return ;
     case PartialAlias:
@@ -453,10 +549,10 @@ void PDGAnalysis::addEdgeFromMemoryAlias (PDG *pdg, Function &F, AAResults &AA,
    *
    * Check if SVF is enabled.
    */
-  if (this->disableSVF){
+  if (!this->canUseSVF(F)){
 
     /*
-     * SVF is disabled.
+     * SVF is disabled or it has been computed before @F was modified.
      */
 
   } else {
@@ -464,7 +560,10 @@ void PDGAnalysis::addEdgeFromMemoryAlias (PDG *pdg, Function &F, AAResults &AA,
     /*
      * SVF is enabled, so let's use it.
      */
-    switch (this->pta->alias(MemoryLocation::get(instI), MemoryLocation::get(instJ))) {
+    auto svfAlias = this->aliasQueryCache.alias(AliasQueryCache::SVF_ALIAS, locationI, locationJ, [this, &locationI, &locationJ](void) {
+      return this->pta->alias(locationI, locationJ);
+    });
+    switch (svfAlias) {
       case NoAlias:
         return;
       case PartialAlias:
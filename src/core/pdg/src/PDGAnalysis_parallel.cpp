@@ -0,0 +1,128 @@
+/*
+ * Copyright 2016 - 2020  Angelo Matni, Yian Su, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "SystemHeaders.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "PDGAnalysis.hpp"
+
+using namespace llvm;
+
+void PDGAnalysis::constructEdgesFromAliasesAndControlInParallel (PDG *pdg, Module &M){
+  assert(pdg != nullptr);
+
+  /*
+   * Fetch the functions with a body.
+   */
+  std::vector<Function *> functions;
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue ;
+    }
+    functions.push_back(&F);
+  }
+
+  /*
+   * Compute the information of each function that does not depend on the pass manager in parallel.
+   *
+   * Each function has its own buffers and threads only read the IR; they share only the index of the next function to compute.
+   * Alias analyses are not queried here: the per-function analyses of the legacy pass manager and the SVF caches are not thread safe.
+   *
+   * The calling thread consumes the reachability results in order while the workers compute the next ones.
+   * Workers never run more than a few functions ahead of the calling thread, so only a few results are alive at any time.
+   */
+  std::vector<DataFlowResult *> reachableInsts(functions.size(), nullptr);
+  std::vector<ControlDependences> controlDependences(functions.size());
+  std::vector<bool> isFunctionReady(functions.size(), false);
+  std::mutex lock;
+  std::condition_variable hasStateChanged;
+  uint64_t nextFunctionIndex = 0;
+  uint64_t numberOfConsumedFunctions = 0;
+  auto threadsToUse = std::max<uint64_t>(std::min<uint64_t>(this->numberOfThreads - 1, functions.size()), 1);
+  auto maximumFunctionsAhead = 2 * threadsToUse;
+  auto computeFunctionInformation = [&](void) -> void {
+    while (true) {
+
+      /*
+       * Fetch the next function, without running too far ahead of the calling thread.
+       */
+      uint64_t functionIndex;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        hasStateChanged.wait(guard, [&](void) -> bool {
+          return (nextFunctionIndex >= functions.size())
+                 || (nextFunctionIndex < (numberOfConsumedFunctions + maximumFunctionsAhead));
+        });
+        if (nextFunctionIndex >= functions.size()) {
+          return ;
+        }
+        functionIndex = nextFunctionIndex++;
+      }
+      auto F = functions[functionIndex];
+
+      /*
+       * Compute the information of the function.
+       */
+      auto dfr = this->computeReachableMemoryInstructions(*F);
+      PostDominatorTree postDomTree(*F);
+      auto controlDependencesOfF = this->computeControlDependences(*F, postDomTree);
+
+      /*
+       * Publish the information.
+       */
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        reachableInsts[functionIndex] = dfr;
+        controlDependences[functionIndex] = std::move(controlDependencesOfF);
+        isFunctionReady[functionIndex] = true;
+      }
+      hasStateChanged.notify_all();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0; i < threadsToUse; i++) {
+    threads.push_back(std::thread(computeFunctionInformation));
+  }
+
+  /*
+   * Add the edges to the PDG following the same order of the serial construction.
+   * This makes the PDG identical to the one built by a single thread.
+   */
+  for (size_t i = 0; i < functions.size(); i++) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      hasStateChanged.wait(guard, [&](void) -> bool {
+        return isFunctionReady[i];
+      });
+    }
+    this->constructEdgesFromAliasesForFunction(pdg, *functions[i], reachableInsts[i]);
+    delete reachableInsts[i];
+    reachableInsts[i] = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      numberOfConsumedFunctions++;
+    }
+    hasStateChanged.notify_all();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (verbose >= PDGVerbosity::Maximal) {
+    errs() << "PDGAnalysis: Computed the dependences of " << functions.size() << " functions using " << threadsToUse << " worker threads\n";
+  }
+  for (size_t i = 0; i < functions.size(); i++) {
+    this->constructEdgesFromControlForFunction(pdg, *functions[i], controlDependences[i]);
+  }
+
+  return ;
+}
@@ -25,6 +25,7 @@ static cl::opt<bool> PDGCheck("noelle-pdg-check", cl::ZeroOrMore, cl::Hidden, cl
 static cl::opt<bool> PDGSVFDisable("noelle-disable-pdg-svf", cl::ZeroOrMore, cl::Hidden, cl::desc("Disable SVF"));
 static cl::opt<bool> PDGAllocAADisable("noelle-disable-pdg-allocaa", cl::ZeroOrMore, cl::Hidden, cl::desc("Disable our custom alias analysis"));
 static cl::opt<bool> PDGRADisable("noelle-disable-pdg-reaching-analysis", cl::ZeroOrMore, cl::Hidden, cl::desc("Disable the use of reaching analysis to compute the PDG"));
+static cl::opt<unsigned> PDGThreads("noelle-pdg-threads", cl::ZeroOrMore, cl::Hidden, cl::init(1), cl::desc("Number of threads used to compute the reachable memory instructions and the control dependences of functions; alias queries are always serial (0: all cores)"));
 
 bool PDGAnalysis::doInitialization (Module &M){
   this->verbose = static_cast<PDGVerbosity>(PDGVerbose.getValue());
@@ -34,6 +35,10 @@ bool PDGAnalysis::doInitialization (Module &M){
   this->disableSVF = (PDGSVFDisable.getNumOccurrences() > 0) ? true : false;
   this->disableAllocAA = (PDGAllocAADisable.getNumOccurrences() > 0) ? true : false;
   this->disableRA = (PDGRADisable.getNumOccurrences() > 0) ? true : false;
+  this->numberOfThreads = PDGThreads.getValue();
+  if (this->numberOfThreads == 0){
+    this->numberOfThreads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
 
   return false;
 }
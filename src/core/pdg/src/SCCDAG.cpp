@@ -9,7 +9,6 @@
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <SystemHeaders.hpp>
-#include "DGGraphTraits.hpp"
 #include "SCCDAG.hpp"
 #include "llvm/InitializePasses.h"
 
@@ -18,52 +17,143 @@ using namespace llvm ;
 SCCDAG::SCCDAG(PDG *pdg) {
 
   /*
-   * Create nodes of the SCCDAG.
-   *
-   * Iterate over all nodes in the PDG to calculate strongly connected components (see Tarjan's DFS algo).
+   * Assign dense IDs to the nodes of the PDG.
    */
-  std::set<DGNode<Value> *> visited;
-  DGNode<Value> *originalEntryNode = pdg->getEntryNode();
-
-  for (auto nodeToVisit : pdg->getNodes()) {
-    if (visited.find(nodeToVisit) != visited.end()) continue;
-
-    pdg->setEntryNode(nodeToVisit);
+  std::vector<DGNode<Value> *> nodes;
+  std::unordered_map<DGNode<Value> *, uint32_t> nodeIDs;
+  for (auto node : pdg->getNodes()) {
+    nodeIDs[node] = nodes.size();
+    nodes.push_back(node);
+  }
+  const uint32_t numberOfNodes = nodes.size();
+  const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
 
-    DGGraphWrapper<PDG, Value> pdgWrapper(pdg);
+  /*
+   * Compute the successors of every node.
+   *
+   * Successors are ordered by the address of their edge to visit them in the same order of the DGGraphWrapper used by llvm::scc_iterator.
+   * This keeps the order of the SCCs identical to the one produced by llvm::scc_iterator.
+   */
+  std::vector<std::vector<uint32_t>> successors(numberOfNodes);
+  std::vector<DGEdge<Value> *> outgoingEdges;
+  for (uint32_t nodeID = 0; nodeID < numberOfNodes; nodeID++) {
+    auto node = nodes[nodeID];
+    outgoingEdges.assign(node->begin_outgoing_edges(), node->end_outgoing_edges());
+    std::sort(outgoingEdges.begin(), outgoingEdges.end());
+    for (auto edge : outgoingEdges) {
+      auto successorIt = nodeIDs.find(edge->getIncomingNode());
+      if (successorIt == nodeIDs.end()) continue;
+      successors[nodeID].push_back(successorIt->second);
+    }
+  }
 
-    for (auto pdgI = scc_begin(&pdgWrapper); pdgI != scc_end(&pdgWrapper); ++pdgI) {
+  /*
+   * Compute the strongly connected components (see Tarjan's DFS algo).
+   *
+   * This is a single iterative pass over all nodes.
+   * Components are numbered in the order they are completed, which is a reverse topological order of the SCCDAG.
+   */
+  std::vector<uint32_t> visitNumber(numberOfNodes, unassigned);
+  std::vector<uint32_t> lowLink(numberOfNodes, unassigned);
+  std::vector<uint32_t> componentOfNode(numberOfNodes, unassigned);
+  std::vector<std::vector<uint32_t>> components;
+  std::vector<uint32_t> nodesOnStack;
+  std::vector<std::pair<uint32_t, uint32_t>> visitStack;
+  uint32_t visitCounter = 0;
+  auto visitNode = [&](uint32_t nodeID) {
+    visitNumber[nodeID] = visitCounter;
+    lowLink[nodeID] = visitCounter;
+    visitCounter++;
+    nodesOnStack.push_back(nodeID);
+    visitStack.push_back(std::make_pair(nodeID, 0));
+  };
+  for (uint32_t rootID = 0; rootID < numberOfNodes; rootID++) {
+    if (visitNumber[rootID] != unassigned) continue;
+
+    visitNode(rootID);
+    while (!visitStack.empty()) {
+      auto nodeID = visitStack.back().first;
+      auto nextSuccessor = visitStack.back().second;
 
       /*
-       * Identify a new SCC.
+       * Visit the next successor of the current node.
        */
-      const std::vector<DGNodeWrapper<Value> *> &sccNodes = *pdgI;
-      auto firstNodeWrapper = *sccNodes.begin();
-      auto firstNode = firstNodeWrapper->wrappedNode;
-      if (visited.find(firstNode) != visited.end()) {
+      if (nextSuccessor < successors[nodeID].size()) {
+        visitStack.back().second++;
+        auto successorID = successors[nodeID][nextSuccessor];
+        if (visitNumber[successorID] == unassigned) {
+          visitNode(successorID);
+          continue;
+        }
+        if (componentOfNode[successorID] == unassigned) {
+          lowLink[nodeID] = std::min(lowLink[nodeID], visitNumber[successorID]);
+        }
         continue;
       }
 
-      std::set<DGNode<Value> *> unwrappedNodes{};
-      for (auto sccNode : sccNodes) {
-        unwrappedNodes.insert(sccNode->wrappedNode);
-      }
-
       /*
-       * Add a new SCC to the SCCDAG.
+       * All successors have been visited.
        */
-      visited.insert(unwrappedNodes.begin(), unwrappedNodes.end());
-      auto scc = new SCC(unwrappedNodes);
-      auto isInternal = false;
-      for (auto node : unwrappedNodes) {
-        isInternal |= pdg->isInternal(node->getT());
+      visitStack.pop_back();
+      if (!visitStack.empty()) {
+        auto parentID = visitStack.back().first;
+        lowLink[parentID] = std::min(lowLink[parentID], lowLink[nodeID]);
       }
+      if (lowLink[nodeID] != visitNumber[nodeID]) continue;
 
-      this->addNode(scc, /*inclusion=*/ isInternal);
+      /*
+       * The current node is the root of a new SCC.
+       */
+      auto componentID = components.size();
+      components.emplace_back();
+      uint32_t memberID;
+      do {
+        memberID = nodesOnStack.back();
+        nodesOnStack.pop_back();
+        componentOfNode[memberID] = componentID;
+        components[componentID].push_back(memberID);
+      } while (memberID != nodeID);
     }
   }
 
-  pdg->setEntryNode(originalEntryNode);
+  /*
+   * Create nodes of the SCCDAG.
+   *
+   * The internal and external nodes of each SCC are identified by comparing the components of the two ends of each dependence.
+   */
+  auto componentOf = [&](DGNode<Value> *node) -> uint32_t {
+    auto nodeIt = nodeIDs.find(node);
+    return nodeIt == nodeIDs.end() ? unassigned : componentOfNode[nodeIt->second];
+  };
+  for (uint32_t componentID = 0; componentID < components.size(); componentID++) {
+    std::set<DGNode<Value> *> internalNodes;
+    std::set<DGNode<Value> *> externalNodes;
+    auto isInternal = false;
+    for (auto nodeID : components[componentID]) {
+      auto node = nodes[nodeID];
+      internalNodes.insert(node);
+      isInternal |= pdg->isInternal(node->getT());
+
+      for (auto edge : node->getOutgoingEdges()) {
+        auto otherNode = edge->getIncomingNode();
+        if (componentOf(otherNode) != componentID) {
+          externalNodes.insert(otherNode);
+        }
+      }
+      for (auto edge : node->getIncomingEdges()) {
+        auto otherNode = edge->getOutgoingNode();
+        if (componentOf(otherNode) != componentID) {
+          externalNodes.insert(otherNode);
+        }
+      }
+    }
+
+    /*
+     * Add a new SCC to the SCCDAG.
+     */
+    auto scc = new SCC(internalNodes, externalNodes);
+    this->addNode(scc, /*inclusion=*/ isInternal);
+  }
 
   /*
    * Create the map from a Value to an SCC included in the SCCDAG.
@@ -123,6 +213,17 @@ void SCCDAG::markEdgesAndSubEdges (void) {
      */
     auto outgoingSCC = outgoingSCCNode->getT();
 
+    /*
+     * Collect the edges that already connect the current SCC to the other ones.
+     */
+    std::unordered_map<DGNode<SCC> *, DGEdge<SCC> *> edgeOfSCC;
+    for (auto edge : outgoingSCCNode->getOutgoingEdges()) {
+      edgeOfSCC.insert(std::make_pair(edge->getIncomingNode(), edge));
+    }
+    for (auto edge : outgoingSCCNode->getIncomingEdges()) {
+      edgeOfSCC.insert(std::make_pair(edge->getOutgoingNode(), edge));
+    }
+
     /*
      * Check dependences that go outside the current SCC.
      */
@@ -136,16 +237,14 @@ void SCCDAG::markEdgesAndSubEdges (void) {
       /*
        * Find or create unique edge between the two connected SCC
        */
-      std::unordered_set<DGEdge<SCC> *> edgeSet;
-      for (auto edge : outgoingSCCNode->getOutgoingEdges()) {
-        if (edge->getIncomingNode() != incomingSCCNode) continue;
-        edgeSet.insert(edge);
+      auto edgeIt = edgeOfSCC.find(incomingSCCNode);
+      DGEdge<SCC> *sccEdge;
+      if (edgeIt != edgeOfSCC.end()) {
+        sccEdge = edgeIt->second;
+      } else {
+        sccEdge = this->addEdge(outgoingSCC, incomingSCC);
+        edgeOfSCC[incomingSCCNode] = sccEdge;
       }
-      for (auto edge : outgoingSCCNode->getIncomingEdges()) {
-        if (edge->getOutgoingNode() != incomingSCCNode) continue;
-        edgeSet.insert(edge);
-      }
-      auto sccEdge = edgeSet.empty() ? this->addEdge(outgoingSCC, incomingSCC) : (*edgeSet.begin());
 
       /*
        * Clear out subedges if not already done once; add all currently existing subedges
@@ -313,18 +412,6 @@ std::unordered_set<SCC *> SCCDAG::getSCCs (void) {
 }
 
 SCCDAG::~SCCDAG() {
-  for (auto *edge : allEdges){
-    if (edge) {
-      delete edge;
-    }
-  }
-
-  for (auto *node : allNodes){
-    if (node) {
-      delete node;
-    }
-  }
-
   this->clear();
 
   return ;
@@ -3,6 +3,10 @@
 #include <atomic>
 #include <cstdint>
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -19,6 +23,11 @@
 #include <queue>
 #include <utility>
 #include <iostream>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+#include <time.h>
 
 using namespace MARC;
 
@@ -48,6 +57,12 @@ extern "C" {
    */
   int32_t NOELLE_getNumberOfCores (void);
 
+  /*
+   * Set the ID of the loop the next dispatcher invoked by the current thread executes.
+   * The ID is used only by the profiler (see NOELLE_PROFILE).
+   */
+  void NOELLE_setLoopID (int64_t loopID);
+
   /*
    * Dispatch threads to run a DOALL loop.
    */
@@ -58,11 +73,163 @@ extern "C" {
     int64_t chunkSize
     );
 
+  /*
+   * Dispatch threads to run a DOALL loop.
+   *
+   * The number of iterations of the invocation (or an estimate of it) is used to choose how many cores to use, up to @maxNumberOfCores; 0 means unknown.
+   */
+  DispatcherInfo NOELLE_DOALLDispatcherWithIterations (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations
+    );
+
+  /*
+   * Dispatch threads to run a DOALL loop whose chunks of iterations are assigned to cores at runtime.
+   *
+   * The schedule is one of NOELLE_DOALL_STATIC_SCHEDULE, NOELLE_DOALL_DYNAMIC_SCHEDULE, and NOELLE_DOALL_GUIDED_SCHEDULE.
+   * It can be overwritten by the environment variable NOELLE_DOALL_SCHEDULE ("static", "dynamic", or "guided").
+   * The number of iterations is only an estimate used by the guided schedule and to choose how many cores to use; 0 means unknown.
+   */
+  DispatcherInfo NOELLE_DOALLDispatcherWithSchedule (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t, void *), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t schedule,
+    int64_t numberOfIterations
+    );
+
+  /*
+   * Return the index of the next chunk of iterations the core @coreID has to execute.
+   * If the current chunk is not completed, then @currentChunk is returned.
+   */
+  int64_t NOELLE_DOALL_nextChunk (
+    void *schedule,
+    int64_t coreID,
+    int64_t currentChunk,
+    bool isChunkCompleted
+    );
+
 
   /******************************************** NOELLE API implementations ***********************************************/
 
 
 
+  /**********************************************************************
+   *                TOPOLOGY
+   *
+   * The topology of the machine is read from /sys/devices/system/cpu.
+   * Only the logical cores the process is allowed to run on are considered.
+   * Logical cores are grouped by the physical core they belong to, and threads are placed on one logical core per physical core first.
+   **********************************************************************/
+  typedef struct {
+    std::vector<std::vector<int32_t>> physicalCores;
+    std::vector<int32_t> placementOrder;
+  } NOELLE_topology_t;
+
+  static int64_t NOELLE_readSysFile (int32_t logicalCore, const char *fileName){
+    char path[256];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/%s", logicalCore, fileName);
+    auto file = fopen(path, "r");
+    if (file == nullptr){
+      return -1;
+    }
+    long long value;
+    if (fscanf(file, "%lld", &value) != 1){
+      value = -1;
+    }
+    fclose(file);
+
+    return value;
+  }
+
+  static const NOELLE_topology_t & NOELLE_getTopology (void){
+    static NOELLE_topology_t topology;
+    static std::once_flag topologyIsReady;
+
+    std::call_once(topologyIsReady, [](){
+
+      /*
+       * Fetch the logical cores we are allowed to use.
+       */
+      std::vector<int32_t> logicalCores;
+      cpu_set_t allowedCores;
+      CPU_ZERO(&allowedCores);
+      if (sched_getaffinity(0, sizeof(cpu_set_t), &allowedCores) == 0){
+        for (auto core = 0; core < CPU_SETSIZE; core++){
+          if (CPU_ISSET(core, &allowedCores)){
+            logicalCores.push_back(core);
+          }
+        }
+      }
+      if (logicalCores.size() == 0){
+        for (auto core = 0U; core < std::max(std::thread::hardware_concurrency(), 1U); core++){
+          logicalCores.push_back(core);
+        }
+      }
+
+      /*
+       * Group the logical cores by physical core.
+       * A logical core with an unknown topology is considered a physical core on its own.
+       */
+      std::vector<std::pair<int64_t, int64_t>> physicalCoreIDs;
+      for (auto logicalCore : logicalCores){
+        auto socketID = NOELLE_readSysFile(logicalCore, "topology/physical_package_id");
+        auto coreID = NOELLE_readSysFile(logicalCore, "topology/core_id");
+        if ((socketID == -1) || (coreID == -1)){
+          socketID = -1;
+          coreID = logicalCore;
+        }
+        auto key = std::make_pair(socketID, coreID);
+        auto it = std::find(physicalCoreIDs.begin(), physicalCoreIDs.end(), key);
+        if (it == physicalCoreIDs.end()){
+          physicalCoreIDs.push_back(key);
+          topology.physicalCores.push_back({});
+          it = physicalCoreIDs.end() - 1;
+        }
+        topology.physicalCores[it - physicalCoreIDs.begin()].push_back(logicalCore);
+      }
+
+      /*
+       * Compute the placement order: the i-th logical core of every physical core comes before the (i+1)-th one.
+       */
+      for (size_t sibling = 0; topology.placementOrder.size() < logicalCores.size(); sibling++){
+        for (auto &physicalCore : topology.physicalCores){
+          if (sibling < physicalCore.size()){
+            topology.placementOrder.push_back(physicalCore[sibling]);
+          }
+        }
+      }
+    });
+
+    return topology;
+  }
+
+  /*
+   * Return the logical core where the thread @slot should run.
+   */
+  static int32_t NOELLE_getLogicalCoreOfSlot (int32_t slot){
+    auto &placementOrder = NOELLE_getTopology().placementOrder;
+
+    return placementOrder[slot % placementOrder.size()];
+  }
+
+  /*
+   * Add to @cores all logical cores of the physical core where the thread @slot should run.
+   */
+  static void NOELLE_setPhysicalCoreOfSlot (int32_t slot, cpu_set_t *cores){
+    auto &physicalCores = NOELLE_getTopology().physicalCores;
+    for (auto logicalCore : physicalCores[slot % physicalCores.size()]){
+      CPU_SET(logicalCore, cores);
+    }
+
+    return ;
+  }
+
+
   /**********************************************************************
    *                MISC
    **********************************************************************/
@@ -79,7 +246,7 @@ extern "C" {
        */
       auto envVar = getenv("NOELLE_CORES");
       if (envVar == nullptr){
-        cores = std::thread::hardware_concurrency();
+        cores = NOELLE_getTopology().placementOrder.size();
       } else {
         cores = atoi(envVar);
       }
@@ -108,171 +275,1330 @@ extern "C" {
     printf("Pulled: %p\n", p);
   }
 
-  void queuePush8(ThreadSafeQueue<int8_t> *queue, int8_t *val) { 
-    queue->push(*val); 
+  /**********************************************************************
+   *                PROFILER
+   *
+   * When the environment variable NOELLE_PROFILE is set, the dispatchers profile every invocation of a parallelized loop.
+   * The profile is dumped at exit as JSON to the file named by NOELLE_PROFILE.
+   * Loops are identified by the ID the compiler passes through NOELLE_setLoopID before invoking a dispatcher (-1 if unknown).
+   *
+   * Times are in nanoseconds.
+   * The wait time of a thread is the part of an invocation the thread did not spend executing its task (e.g., load imbalance).
+   **********************************************************************/
+  typedef struct {
+    alignas(CACHE_LINE_SIZE) uint64_t busyTime;
+    uint8_t *ssArray;
+    int64_t numberOfSequentialSegments;
+    uint64_t *sequentialSegmentsWaitTime;
+  } NOELLE_profilerThread_t;
 
-    #ifdef DSWP_STATS
-    numberOfPushes8++;
-    #endif
+  typedef struct {
+    int64_t loopID;
+    const char *technique;
+    uint64_t start;
+    int64_t numberOfThreads;
+    int64_t numberOfSequentialSegments;
+    NOELLE_profilerThread_t *threads;
+    uint64_t *sequentialSegmentsWaitTime;
+  } NOELLE_profilerInvocation_t;
+
+  typedef struct {
+    uint64_t pushStalls;
+    uint64_t popStalls;
+    uint64_t occupancy;
+    uint64_t occupancySamples;
+  } NOELLE_profilerQueue_t;
+
+  typedef struct {
+    std::string technique;
+    uint64_t invocations;
+    uint64_t wallTime;
+    std::vector<uint64_t> busyTime;
+    std::vector<uint64_t> waitTime;
+    std::vector<uint64_t> sequentialSegmentsWaitTime;
+    std::vector<NOELLE_profilerQueue_t> queues;
+  } NOELLE_profilerLoop_t;
+
+  static struct {
+    std::string outputFileName;
+    std::mutex lock;
+    std::map<int64_t, NOELLE_profilerLoop_t> loops;
+  } NOELLE_profiler;
+
+  static thread_local int64_t NOELLE_profilerLoopID = -1;
+  static thread_local NOELLE_profilerThread_t *NOELLE_profilerCurrentThread = nullptr;
+
+  void NOELLE_setLoopID (int64_t loopID){
+    NOELLE_profilerLoopID = loopID;
 
     return ;
   }
 
-  void queuePop8(ThreadSafeQueue<int8_t> *queue, int8_t *val) { 
-    queue->waitPop(*val); 
-    return ;
+  static uint64_t NOELLE_profilerNow (void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec) * 1000000000 + now.tv_nsec;
   }
 
-  void queuePush16(ThreadSafeQueue<int16_t> *queue, int16_t *val) { 
-    queue->push(*val); 
+  static void NOELLE_profilerDump (void){
+    auto file = fopen(NOELLE_profiler.outputFileName.c_str(), "w");
+    if (file == nullptr){
+      fprintf(stderr, "NOELLE: Profiler: ERROR = cannot open \"%s\"\n", NOELLE_profiler.outputFileName.c_str());
+      return ;
+    }
 
-    #ifdef DSWP_STATS
-    numberOfPushes16++;
-    #endif
+    /*
+     * Dump the loops.
+     */
+    auto printArray = [file](const char *name, const std::vector<uint64_t> &values){
+      fprintf(file, ",\n      \"%s\": [", name);
+      for (size_t i = 0; i < values.size(); i++){
+        fprintf(file, "%s%llu", (i > 0) ? ", " : "", (unsigned long long)values[i]);
+      }
+      fprintf(file, "]");
+    };
+    std::lock_guard<std::mutex> guard(NOELLE_profiler.lock);
+    fprintf(file, "{\n  \"loops\": [");
+    auto isFirstLoop = true;
+    for (auto &pair : NOELLE_profiler.loops){
+      auto &loop = pair.second;
+      fprintf(file, "%s\n    {\n", isFirstLoop ? "" : ",");
+      fprintf(file, "      \"ID\": %lld,\n", (long long)pair.first);
+      fprintf(file, "      \"technique\": \"%s\",\n", loop.technique.c_str());
+      fprintf(file, "      \"invocations\": %llu,\n", (unsigned long long)loop.invocations);
+      fprintf(file, "      \"wallTime\": %llu", (unsigned long long)loop.wallTime);
+      printArray("threadsBusyTime", loop.busyTime);
+      printArray("threadsWaitTime", loop.waitTime);
+      if (loop.sequentialSegmentsWaitTime.size() > 0){
+        printArray("sequentialSegmentsWaitTime", loop.sequentialSegmentsWaitTime);
+      }
+      if (loop.queues.size() > 0){
+        fprintf(file, ",\n      \"queues\": [");
+        for (size_t i = 0; i < loop.queues.size(); i++){
+          auto &queue = loop.queues[i];
+          auto averageOccupancy = (queue.occupancySamples > 0) ? ((double)queue.occupancy) / queue.occupancySamples : 0;
+          fprintf(file, "%s\n        { \"pushStalls\": %llu, \"popStalls\": %llu, \"averageOccupancy\": %.2f }", (i > 0) ? "," : "", (unsigned long long)queue.pushStalls, (unsigned long long)queue.popStalls, averageOccupancy);
+        }
+        fprintf(file, "\n      ]");
+      }
+      fprintf(file, "\n    }");
+      isFirstLoop = false;
+    }
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
 
     return ;
   }
 
-  void queuePop16(ThreadSafeQueue<int16_t> *queue, int16_t *val) { 
-    queue->waitPop(*val);
+  static bool NOELLE_profilerIsEnabled (void){
+
+    /*
+     * The initialization of a static local variable is thread safe, so the dump is registered at most once.
+     */
+    static const bool isEnabled = [](void) -> bool {
+      auto envVar = getenv("NOELLE_PROFILE");
+      if (  (envVar == nullptr)
+            || (envVar[0] == '\0')  ){
+        return false;
+      }
+      NOELLE_profiler.outputFileName = envVar;
+      atexit(NOELLE_profilerDump);
+
+      return true;
+    }();
+
+    return isEnabled;
+  }
+
+  /*
+   * Start profiling an invocation of a parallelized loop.
+   * It returns nullptr if the profiler is disabled; all other functions of the profiler accept nullptr and do nothing.
+   */
+  static NOELLE_profilerInvocation_t * NOELLE_profilerBegin (const char *technique, int64_t numberOfThreads, int64_t numberOfSequentialSegments){
+
+    /*
+     * Consume the ID of the loop.
+     */
+    auto loopID = NOELLE_profilerLoopID;
+    NOELLE_profilerLoopID = -1;
+    if (!NOELLE_profilerIsEnabled()){
+      return nullptr;
+    }
+
+    /*
+     * Allocate the invocation.
+     */
+    auto invocation = new NOELLE_profilerInvocation_t();
+    invocation->loopID = loopID;
+    invocation->technique = technique;
+    invocation->numberOfThreads = numberOfThreads;
+    invocation->numberOfSequentialSegments = numberOfSequentialSegments;
+    posix_memalign((void **)&invocation->threads, CACHE_LINE_SIZE, sizeof(NOELLE_profilerThread_t) * numberOfThreads);
+    invocation->sequentialSegmentsWaitTime = (uint64_t *) calloc(std::max<int64_t>(numberOfThreads * numberOfSequentialSegments, 1), sizeof(uint64_t));
+    for (auto i = 0; i < numberOfThreads; i++){
+      auto thread = &invocation->threads[i];
+      thread->busyTime = 0;
+      thread->ssArray = nullptr;
+      thread->numberOfSequentialSegments = numberOfSequentialSegments;
+      thread->sequentialSegmentsWaitTime = &invocation->sequentialSegmentsWaitTime[i * numberOfSequentialSegments];
+    }
+    invocation->start = NOELLE_profilerNow();
+
+    return invocation;
   }
 
-  void queuePush32(ThreadSafeQueue<int32_t> *queue, int32_t *val) { 
-    queue->push(*val); 
+  /*
+   * The thread @threadID of @invocation starts executing its task.
+   * @ssArray is the array of sequential segments the task waits on (HELIX only).
+   */
+  static inline uint64_t NOELLE_profilerTaskBegin (NOELLE_profilerInvocation_t *invocation, int64_t threadID, void *ssArray){
+    if (invocation == nullptr){
+      return 0;
+    }
+    auto thread = &invocation->threads[threadID];
+    thread->ssArray = (uint8_t *)ssArray;
+    NOELLE_profilerCurrentThread = thread;
+
+    return NOELLE_profilerNow();
+  }
 
-    #ifdef DSWP_STATS
-    numberOfPushes32++;
-    #endif
+  static inline void NOELLE_profilerTaskEnd (NOELLE_profilerInvocation_t *invocation, int64_t threadID, uint64_t start){
+    if (invocation == nullptr){
+      return ;
+    }
+    invocation->threads[threadID].busyTime = NOELLE_profilerNow() - start;
+    NOELLE_profilerCurrentThread = nullptr;
 
     return ;
   }
 
-  void queuePop32(ThreadSafeQueue<int32_t> *queue, int32_t *val) { 
-    queue->waitPop(*val);
-  }
+  /*
+   * The current thread waited on the sequential segment @sequentialSegment since @start.
+   */
+  static void NOELLE_profilerWaited (NOELLE_profilerThread_t *thread, void *sequentialSegment, uint64_t start){
+    if (thread->ssArray == nullptr){
+      return ;
+    }
+    auto ssID = (((uint8_t *)sequentialSegment) - thread->ssArray) / CACHE_LINE_SIZE;
+    if (  (ssID < 0)
+          || (ssID >= thread->numberOfSequentialSegments)  ){
+      return ;
+    }
+    thread->sequentialSegmentsWaitTime[ssID] += NOELLE_profilerNow() - start;
 
-  void queuePush64(ThreadSafeQueue<int64_t> *queue, int64_t *val) { 
-    queue->push(*val); 
+    return ;
+  }
 
-    #ifdef DSWP_STATS
-    numberOfPushes64++;
-    #endif
+  static void NOELLE_profilerQueue (NOELLE_profilerInvocation_t *invocation, int64_t queueID, const NOELLE_profilerQueue_t &queueProfile){
+    if (invocation == nullptr){
+      return ;
+    }
+    std::lock_guard<std::mutex> guard(NOELLE_profiler.lock);
+    auto &loop = NOELLE_profiler.loops[invocation->loopID];
+    if (loop.queues.size() <= (uint64_t)queueID){
+      loop.queues.resize(queueID + 1, NOELLE_profilerQueue_t{0, 0, 0, 0});
+    }
+    auto &queue = loop.queues[queueID];
+    queue.pushStalls += queueProfile.pushStalls;
+    queue.popStalls += queueProfile.popStalls;
+    queue.occupancy += queueProfile.occupancy;
+    queue.occupancySamples += queueProfile.occupancySamples;
 
     return ;
   }
 
-  void queuePop64(ThreadSafeQueue<int64_t> *queue, int64_t *val) { 
-    queue->waitPop(*val); 
+  /*
+   * Stop profiling an invocation, and add its profile to the one of its loop.
+   */
+  static void NOELLE_profilerEnd (NOELLE_profilerInvocation_t *invocation){
+    if (invocation == nullptr){
+      return ;
+    }
+    auto wallTime = NOELLE_profilerNow() - invocation->start;
+
+    /*
+     * Add the invocation to the profile of the loop.
+     */
+    {
+      std::lock_guard<std::mutex> guard(NOELLE_profiler.lock);
+      auto &loop = NOELLE_profiler.loops[invocation->loopID];
+      loop.technique = invocation->technique;
+      loop.invocations++;
+      loop.wallTime += wallTime;
+      if (loop.busyTime.size() < (uint64_t)invocation->numberOfThreads){
+        loop.busyTime.resize(invocation->numberOfThreads, 0);
+        loop.waitTime.resize(invocation->numberOfThreads, 0);
+      }
+      if (loop.sequentialSegmentsWaitTime.size() < (uint64_t)invocation->numberOfSequentialSegments){
+        loop.sequentialSegmentsWaitTime.resize(invocation->numberOfSequentialSegments, 0);
+      }
+      for (auto i = 0; i < invocation->numberOfThreads; i++){
+        auto thread = &invocation->threads[i];
+        loop.busyTime[i] += thread->busyTime;
+        loop.waitTime[i] += (wallTime > thread->busyTime) ? (wallTime - thread->busyTime) : 0;
+        for (auto ssID = 0; ssID < invocation->numberOfSequentialSegments; ssID++){
+          loop.sequentialSegmentsWaitTime[ssID] += thread->sequentialSegmentsWaitTime[ssID];
+        }
+      }
+    }
+
+    /*
+     * Free the memory.
+     */
+    free(invocation->threads);
+    free(invocation->sequentialSegmentsWaitTime);
+    delete invocation;
 
     return ;
   }
 
 
   /**********************************************************************
-   *                DOALL
+   *                TEAM OF WORKERS
+   *
+   * When the environment variable NOELLE_TEAM is set to 1, parallelized loops are executed by a persistent team of pinned workers.
+   * The thread that invokes a dispatcher executes the first task, and the workers execute the others.
+   * Each worker waits for a new task by spinning on its own cache line for a while and by then sleeping on a futex.
+   * The end of the parallel execution is detected by a sense-reversing barrier.
+   * Therefore, dispatching tasks to the team requires neither heap allocations nor futures.
+   *
+   * The team is used only if it is free and if it has enough workers; otherwise, the thread pool is used.
    **********************************************************************/
+  #define NOELLE_TEAM_SPIN_ITERATIONS (1 << 14)
+  #define NOELLE_TEAM_ARGUMENTS_SIZE (2 * CACHE_LINE_SIZE)
+
+  #if defined(__x86_64__) || defined(__i386__)
+  #define NOELLE_CPU_RELAX() __builtin_ia32_pause()
+  #else
+  #define NOELLE_CPU_RELAX() 
+  #endif
+
   typedef struct {
-    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t) ;
-    void *env ;
-    int64_t coreID ;
-    int64_t numCores;
-    int64_t chunkSize ;
-  } DOALL_args_t ;
+    std::atomic<uint32_t> go;
+    std::atomic<uint32_t> isSleeping;
+    void (*task)(void *);
+    bool sense;
+    uint8_t padding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<uint32_t>) - sizeof(void (*)(void *)) - sizeof(bool)];
+    uint8_t arguments[NOELLE_TEAM_ARGUMENTS_SIZE];
+  } __attribute__((aligned(CACHE_LINE_SIZE))) NOELLE_teamWorker_t ;
 
-  static void NOELLE_DOALLTrampoline (void *args){
+  typedef struct {
+    NOELLE_teamWorker_t *workers;
+    pthread_t *threads;
+    int64_t numberOfWorkers;
+    uint64_t spinIterations;
+    std::atomic<bool> isBusy;
+    std::atomic<bool> isShuttingDown;
+    bool masterSense;
+    void *scratchMemory;
+    uint64_t scratchMemorySize;
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> barrierCounter;
+    std::atomic<bool> barrierSense;
+    int64_t numberOfParticipants;
+  } NOELLE_team_t ;
+
+  static NOELLE_team_t NOELLE_team;
+
+  static void NOELLE_teamBarrier (bool *localSense){
 
     /*
-     * Fetch the arguments.
+     * Flip the sense of the current thread.
      */
-    auto DOALLArgs = (DOALL_args_t *) args;
+    auto sense = !(*localSense);
+    *localSense = sense;
 
     /*
-     * Invoke
+     * Check if the current thread is the last one to arrive.
      */
-    DOALLArgs->parallelizedLoop(DOALLArgs->env, DOALLArgs->coreID, DOALLArgs->numCores, DOALLArgs->chunkSize);
+    if (NOELLE_team.barrierCounter.fetch_sub(1, std::memory_order_acq_rel) == 1){
+      NOELLE_team.barrierCounter.store(NOELLE_team.numberOfParticipants, std::memory_order_relaxed);
+      NOELLE_team.barrierSense.store(sense, std::memory_order_release);
+      return ;
+    }
+
+    /*
+     * Wait for the other threads.
+     */
+    uint64_t iterations = 0;
+    while (NOELLE_team.barrierSense.load(std::memory_order_acquire) != sense){
+      NOELLE_CPU_RELAX();
+      if (++iterations >= NOELLE_team.spinIterations){
+        sched_yield();
+      }
+    }
 
     return ;
   }
 
-  DispatcherInfo NOELLE_DOALLDispatcher (
-    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
-    void *env, 
-    int64_t maxNumberOfCores, 
-    int64_t chunkSize
-    ){
+  static void * NOELLE_teamWorkerLoop (void *args){
 
     /*
-     * Set the number of cores to use.
+     * Fetch the worker.
      */
-    auto runtimeNumberOfCores = NOELLE_getNumberOfCores();
-    auto numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
-    #ifdef RUNTIME_PRINT
-    std::cerr << "Starting dispatcher: num cores " << numCores << ", chunk size: " << chunkSize << std::endl;
-    #endif
+    auto worker = (NOELLE_teamWorker_t *) args;
 
     /*
-     * Allocate the memory to store the arguments.
+     * Execute the tasks given to the worker.
      */
-    DOALL_args_t *argsForAllCores;
-    posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(DOALL_args_t) * numCores);
+    uint32_t lastTask = 0;
+    while (true){
 
-    /*
-     * Submit DOALL tasks.
-     */
-    std::vector<MARC::TaskFuture<void>> localFutures;
-    for (auto i = 0; i < numCores; ++i) {
+      /*
+       * Wait for a new task.
+       * First, we spin on the cache line of the worker.
+       * Then, we sleep on a futex.
+       */
+      uint64_t iterations = 0;
+      while (worker->go.load(std::memory_order_acquire) == lastTask){
+        if (NOELLE_team.isShuttingDown.load(std::memory_order_relaxed)){
+          return nullptr;
+        }
+        if (++iterations < NOELLE_team.spinIterations){
+          NOELLE_CPU_RELAX();
+          continue ;
+        }
+        worker->isSleeping.store(1, std::memory_order_seq_cst);
+        if (worker->go.load(std::memory_order_seq_cst) == lastTask){
+          syscall(SYS_futex, (uint32_t *)&worker->go, FUTEX_WAIT_PRIVATE, lastTask, nullptr, nullptr, 0);
+        }
+        worker->isSleeping.store(0, std::memory_order_relaxed);
+        iterations = 0;
+      }
+      if (NOELLE_team.isShuttingDown.load(std::memory_order_relaxed)){
+        return nullptr;
+      }
+      lastTask = worker->go.load(std::memory_order_acquire);
 
       /*
-       * Prepare the arguments.
+       * Execute the task.
        */
-      auto argsPerCore = &argsForAllCores[i];
-      argsPerCore->parallelizedLoop = parallelizedLoop;
-      argsPerCore->env = env;
-      argsPerCore->coreID = i;
-      argsPerCore->numCores = numCores;
-      argsPerCore->chunkSize = chunkSize;
+      worker->task((void *)worker->arguments);
 
       /*
-       * Submit
+       * Synchronize with the other participants.
        */
-      //localFutures.push_back(pool.submit(NOELLE_DOALLTrampoline, argsPerCore));
-      localFutures.push_back(pool.submit(parallelizedLoop, env, i, numCores, chunkSize));
-      #ifdef RUNTIME_PRINT
-      std::cerr << "Submitted DOALL task on core " << i << std::endl;
-      #endif
+      NOELLE_teamBarrier(&worker->sense);
     }
-    #ifdef RUNTIME_PRINT
-    std::cerr << "Submitted pool" << std::endl;
-    #endif
+
+    return nullptr;
+  }
+
+  static void NOELLE_teamShutdown (void){
 
     /*
-     * Wait for DOALL tasks.
+     * Wake up all workers and wait for them to terminate.
      */
-    for (auto& future : localFutures){
-      future.get();
+    NOELLE_team.isShuttingDown.store(true, std::memory_order_seq_cst);
+    for (auto i = 0; i < NOELLE_team.numberOfWorkers; ++i){
+      auto worker = &NOELLE_team.workers[i];
+      worker->go.fetch_add(1, std::memory_order_seq_cst);
+      syscall(SYS_futex, (uint32_t *)&worker->go, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+    for (auto i = 0; i < NOELLE_team.numberOfWorkers; ++i){
+      pthread_join(NOELLE_team.threads[i], nullptr);
+    }
+
+    return ;
+  }
+
+  static bool NOELLE_createTeam (void){
+    auto envVar = getenv("NOELLE_TEAM");
+    if (  (envVar == nullptr)
+          || (atoi(envVar) != 1)  ){
+      return false;
+    }
+
+    /*
+     * Create the workers.
+     * The thread that invokes the dispatchers is the first participant of the team.
+     */
+    auto numberOfWorkers = NOELLE_getNumberOfCores() - 1;
+    if (numberOfWorkers < 1){
+      return false;
+    }
+    posix_memalign((void **)&NOELLE_team.workers, CACHE_LINE_SIZE, sizeof(NOELLE_teamWorker_t) * numberOfWorkers);
+    NOELLE_team.threads = (pthread_t *) malloc(sizeof(pthread_t) * numberOfWorkers);
+    NOELLE_team.numberOfWorkers = numberOfWorkers;
+
+    /*
+     * Spinning only pays off if every participant has its own logical core.
+     */
+    auto numberOfLogicalCores = NOELLE_getTopology().placementOrder.size();
+    NOELLE_team.spinIterations = (((uint64_t)numberOfWorkers + 1) <= numberOfLogicalCores) ? NOELLE_TEAM_SPIN_ITERATIONS : 1;
+    NOELLE_team.isBusy.store(false);
+    NOELLE_team.isShuttingDown.store(false);
+    NOELLE_team.masterSense = false;
+    NOELLE_team.barrierSense.store(false);
+    NOELLE_team.scratchMemory = nullptr;
+    NOELLE_team.scratchMemorySize = 0;
+    for (auto i = 0; i < numberOfWorkers; ++i){
+      auto worker = &NOELLE_team.workers[i];
+      worker->go.store(0);
+      worker->isSleeping.store(0);
+      worker->task = nullptr;
+      worker->sense = false;
+      pthread_create(&NOELLE_team.threads[i], nullptr, NOELLE_teamWorkerLoop, worker);
+
+      /*
+       * Pin the worker.
+       * Workers fill the physical cores first, and only then their SMT siblings.
+       */
+      cpu_set_t cores;
+      CPU_ZERO(&cores);
+      CPU_SET(NOELLE_getLogicalCoreOfSlot(i + 1), &cores);
+      pthread_setaffinity_np(NOELLE_team.threads[i], sizeof(cpu_set_t), &cores);
+    }
+    atexit(NOELLE_teamShutdown);
+
+    return true;
+  }
+
+  static bool NOELLE_teamIsEnabled (void){
+
+    /*
+     * The initialization of a static local variable is thread safe.
+     * Hence, the team is created only once, and no dispatcher can see it enabled before its workers exist.
+     */
+    static const bool isEnabled = NOELLE_createTeam();
+
+    return isEnabled;
+  }
+
+  /*
+   * Try to reserve the team to run @numberOfParticipants tasks in parallel.
+   */
+  static bool NOELLE_teamAcquire (int64_t numberOfParticipants){
+
+    /*
+     * Check if the team can run all tasks at the same time.
+     */
+    if (!NOELLE_teamIsEnabled()){
+      return false;
+    }
+    if (numberOfParticipants > (NOELLE_team.numberOfWorkers + 1)){
+      return false;
+    }
+
+    /*
+     * Check if the team is free.
+     * It is not free when a parallelized loop invokes another one.
+     */
+    auto isBusy = false;
+    if (!NOELLE_team.isBusy.compare_exchange_strong(isBusy, true, std::memory_order_acquire)){
+      return false;
+    }
+
+    /*
+     * Prepare the barrier.
+     */
+    NOELLE_team.numberOfParticipants = numberOfParticipants;
+    NOELLE_team.barrierCounter.store(numberOfParticipants, std::memory_order_relaxed);
+
+    return true;
+  }
+
+  static void * NOELLE_teamArgumentsOfTask (int64_t taskID){
+    assert(taskID > 0);
+    return (void *)NOELLE_team.workers[taskID - 1].arguments;
+  }
+
+  /*
+   * Start the task @taskID of the team (@taskID > 0), which invokes @task with the arguments of the task.
+   */
+  static void NOELLE_teamStartTask (int64_t taskID, void (*task)(void *)){
+    assert(taskID > 0);
+
+    /*
+     * Wake up the worker.
+     * Workers that did not participate in previous parallel executions have a stale sense of the barrier, so they inherit the one of the thread that invokes the dispatcher.
+     */
+    auto worker = &NOELLE_team.workers[taskID - 1];
+    worker->task = task;
+    worker->sense = NOELLE_team.masterSense;
+    worker->go.fetch_add(1, std::memory_order_seq_cst);
+    if (worker->isSleeping.load(std::memory_order_seq_cst)){
+      syscall(SYS_futex, (uint32_t *)&worker->go, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    return ;
+  }
+
+  /*
+   * Wait for all tasks of the team and release the team.
+   */
+  static void NOELLE_teamJoin (void){
+    NOELLE_teamBarrier(&NOELLE_team.masterSense);
+    NOELLE_team.isBusy.store(false, std::memory_order_release);
+
+    return ;
+  }
+
+  /*
+   * Return memory owned by the team that can be used until the team is released.
+   */
+  static void * NOELLE_teamScratchMemory (uint64_t size){
+    if (size > NOELLE_team.scratchMemorySize){
+      free(NOELLE_team.scratchMemory);
+      posix_memalign(&NOELLE_team.scratchMemory, CACHE_LINE_SIZE, size);
+      NOELLE_team.scratchMemorySize = size;
+    }
+
+    return NOELLE_team.scratchMemory;
+  }
+
+
+  /**********************************************************************
+   *                DOALL
+   **********************************************************************/
+  typedef struct {
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t) ;
+    void *env ;
+    int64_t coreID ;
+    int64_t numCores;
+    int64_t chunkSize ;
+    NOELLE_profilerInvocation_t *profile;
+  } DOALL_args_t ;
+  static_assert(sizeof(DOALL_args_t) <= NOELLE_TEAM_ARGUMENTS_SIZE, "DOALL arguments do not fit in a worker of the team");
+
+  static void NOELLE_DOALLTrampoline (void *args){
+
+    /*
+     * Fetch the arguments.
+     */
+    auto DOALLArgs = (DOALL_args_t *) args;
+
+    /*
+     * Invoke
+     */
+    auto start = NOELLE_profilerTaskBegin(DOALLArgs->profile, DOALLArgs->coreID, nullptr);
+    DOALLArgs->parallelizedLoop(DOALLArgs->env, DOALLArgs->coreID, DOALLArgs->numCores, DOALLArgs->chunkSize);
+    NOELLE_profilerTaskEnd(DOALLArgs->profile, DOALLArgs->coreID, start);
+
+    return ;
+  }
+
+  /*
+   * Execute the DOALL tasks of an invocation on @numCores cores.
+   */
+  static void NOELLE_DOALLRun (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t numCores, 
+    int64_t chunkSize,
+    NOELLE_profilerInvocation_t *profile
+    ){
+
+    /*
+     * Check if the invocation is executed sequentially.
+     */
+    if (numCores == 1){
+      DOALL_args_t args;
+      args.parallelizedLoop = parallelizedLoop;
+      args.env = env;
+      args.coreID = 0;
+      args.numCores = 1;
+      args.chunkSize = chunkSize;
+      args.profile = profile;
+      NOELLE_DOALLTrampoline(&args);
+      return ;
+    }
+
+    /*
+     * Check if we can use the team of workers.
+     */
+    if (NOELLE_teamAcquire(numCores)){
+
+      /*
+       * Start the DOALL tasks.
+       */
+      DOALL_args_t argsForTheFirstCore;
+      for (auto i = 0; i < numCores; ++i) {
+        auto argsPerCore = (i == 0) ? &argsForTheFirstCore : (DOALL_args_t *) NOELLE_teamArgumentsOfTask(i);
+        argsPerCore->parallelizedLoop = parallelizedLoop;
+        argsPerCore->env = env;
+        argsPerCore->coreID = i;
+        argsPerCore->numCores = numCores;
+        argsPerCore->chunkSize = chunkSize;
+        argsPerCore->profile = profile;
+        if (i > 0){
+          NOELLE_teamStartTask(i, NOELLE_DOALLTrampoline);
+        }
+      }
+
+      /*
+       * Execute the first DOALL task.
+       */
+      NOELLE_DOALLTrampoline(&argsForTheFirstCore);
+
+      /*
+       * Wait for the other DOALL tasks.
+       */
+      NOELLE_teamJoin();
+
+      return ;
+    }
+
+    /*
+     * Allocate the memory to store the arguments.
+     */
+    DOALL_args_t *argsForAllCores;
+    posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(DOALL_args_t) * numCores);
+
+    /*
+     * Submit DOALL tasks.
+     */
+    std::vector<MARC::TaskFuture<void>> localFutures;
+    for (auto i = 0; i < numCores; ++i) {
+
+      /*
+       * Prepare the arguments.
+       */
+      auto argsPerCore = &argsForAllCores[i];
+      argsPerCore->parallelizedLoop = parallelizedLoop;
+      argsPerCore->env = env;
+      argsPerCore->coreID = i;
+      argsPerCore->numCores = numCores;
+      argsPerCore->chunkSize = chunkSize;
+      argsPerCore->profile = profile;
+
+      /*
+       * Submit
+       */
+      localFutures.push_back(pool.submit(NOELLE_DOALLTrampoline, argsPerCore));
+      #ifdef RUNTIME_PRINT
+      std::cerr << "Submitted DOALL task on core " << i << std::endl;
+      #endif
+    }
+    #ifdef RUNTIME_PRINT
+    std::cerr << "Submitted pool" << std::endl;
+    #endif
+
+    /*
+     * Wait for DOALL tasks.
+     */
+    for (auto& future : localFutures){
+      future.get();
+    }
+    #ifdef RUNTIME_PRINT
+    std::cerr << "Got all futures" << std::endl;
+    #endif
+
+    /*
+     * Free the memory.
+     */
+    free(argsForAllCores);
+
+    return ;
+  }
+
+  /**********************************************************************
+   * Adaptive parallelism.
+   *
+   * The number of cores used by an invocation of a DOALL loop is chosen at runtime from its number of iterations.
+   * The time of an invocation on p cores is modeled as overhead * p + cost * iterations / p, where
+   * - overhead is the time to dispatch a task to a core, which is measured once by dispatching empty tasks, and
+   * - cost is the time of an iteration of the loop, which is measured by every invocation.
+   * The invocation is executed sequentially on the current thread if that is not slower than any parallel execution.
+   *
+   * Loops whose number of iterations is unknown (0) use all cores.
+   * The environment variable NOELLE_DOALL_ADAPTIVE=0 disables the adaptation.
+   *
+   * The overhead is measured once per number of cores.
+   * Numbers of cores beyond NOELLE_DOALL_MAX_CALIBRATED_CORES share the overhead measured for the first of them that is used.
+   **********************************************************************/
+  #define NOELLE_DOALL_LOOPS 1024
+  #define NOELLE_DOALL_CALIBRATION_RUNS 8
+  #define NOELLE_DOALL_MAX_CALIBRATED_CORES 1024
+
+  typedef struct {
+    std::atomic<void *> loop;
+    std::atomic<double> nanosecondsPerIteration;
+  } DOALL_loopCost_t ;
+
+  static DOALL_loopCost_t NOELLE_DOALL_loopCosts[NOELLE_DOALL_LOOPS];
+
+  static std::atomic<double> NOELLE_DOALL_dispatchOverheads[NOELLE_DOALL_MAX_CALIBRATED_CORES + 1];
+  static std::mutex NOELLE_DOALL_calibrationLock;
+
+  static void NOELLE_DOALL_emptyTask (void *env, int64_t coreID, int64_t numCores, int64_t chunkSize){
+    return ;
+  }
+
+  static bool NOELLE_DOALL_isAdaptive (void){
+
+    /*
+     * The initialization of a static local variable is thread safe, so concurrent dispatchers read the environment variable only once.
+     */
+    static const bool isAdaptive = [](void) -> bool {
+      auto envVar = getenv("NOELLE_DOALL_ADAPTIVE");
+      return (envVar == nullptr) || (atoi(envVar) != 0);
+    }();
+
+    return isAdaptive;
+  }
+
+  /*
+   * Return the cost of the loop @loop (i.e., its parallelized body), or nullptr if there is no more room to track it.
+   */
+  static DOALL_loopCost_t * NOELLE_DOALL_getLoopCost (void *loop){
+    auto index = (((uintptr_t)loop) >> 4) % NOELLE_DOALL_LOOPS;
+    for (auto i = 0; i < NOELLE_DOALL_LOOPS; i++){
+      auto loopCost = &NOELLE_DOALL_loopCosts[(index + i) % NOELLE_DOALL_LOOPS];
+      auto currentLoop = loopCost->loop.load(std::memory_order_acquire);
+      if (currentLoop == nullptr){
+        loopCost->loop.compare_exchange_strong(currentLoop, loop);
+        if (currentLoop == nullptr){
+          return loopCost;
+        }
+      }
+      if (currentLoop == loop){
+        return loopCost;
+      }
+    }
+
+    return nullptr;
+  }
+
+  static double NOELLE_DOALL_getDispatchOverhead (int64_t numCores){
+    auto &overheadPerCore = NOELLE_DOALL_dispatchOverheads[std::min<int64_t>(numCores, NOELLE_DOALL_MAX_CALIBRATED_CORES)];
+
+    /*
+     * Check if we have already measured the overhead for this number of cores.
+     * A measured overhead is never smaller than 1.
+     */
+    auto overhead = overheadPerCore.load(std::memory_order_acquire);
+    if (overhead > 0){
+      return overhead;
+    }
+
+    /*
+     * Measure the overhead of dispatching empty tasks.
+     * Only one thread measures it, and the others wait for its result.
+     */
+    std::lock_guard<std::mutex> guard(NOELLE_DOALL_calibrationLock);
+    overhead = overheadPerCore.load(std::memory_order_acquire);
+    if (overhead > 0){
+      return overhead;
+    }
+    auto bestTime = std::numeric_limits<uint64_t>::max();
+    for (auto i = 0; i < NOELLE_DOALL_CALIBRATION_RUNS; i++){
+      auto start = NOELLE_profilerNow();
+      NOELLE_DOALLRun(NOELLE_DOALL_emptyTask, nullptr, numCores, 1, nullptr);
+      bestTime = std::min(bestTime, NOELLE_profilerNow() - start);
+    }
+    overhead = std::max(((double)bestTime) / numCores, 1.0);
+    overheadPerCore.store(overhead, std::memory_order_release);
+
+    return overhead;
+  }
+
+  static int64_t NOELLE_DOALL_chooseNumberOfCores (
+    DOALL_loopCost_t *loopCost,
+    int64_t maxNumberOfCores,
+    int64_t numberOfIterations
+    ){
+
+    /*
+     * Check if we know enough to choose.
+     */
+    if (  (loopCost == nullptr)
+          || (numberOfIterations <= 0)
+          || (maxNumberOfCores <= 1)  ){
+      return maxNumberOfCores;
+    }
+    auto cost = loopCost->nanosecondsPerIteration.load(std::memory_order_relaxed);
+    if (cost <= 0){
+      return maxNumberOfCores;
+    }
+
+    /*
+     * Choose the number of cores that minimizes overhead * p + work / p.
+     */
+    auto overhead = NOELLE_DOALL_getDispatchOverhead(maxNumberOfCores);
+    auto work = cost * numberOfIterations;
+    auto numCores = std::min(std::max((int64_t)std::sqrt(work / overhead), (int64_t)1), maxNumberOfCores);
+
+    /*
+     * Check if the parallel execution pays off.
+     */
+    if (  (numCores > 1)
+          && ((overhead * numCores + work / numCores) >= work)  ){
+      numCores = 1;
+    }
+
+    return numCores;
+  }
+
+  static void NOELLE_DOALL_updateLoopCost (
+    DOALL_loopCost_t *loopCost,
+    int64_t numCores,
+    int64_t numberOfIterations,
+    uint64_t time
+    ){
+    if (  (loopCost == nullptr)
+          || (numberOfIterations <= 0)  ){
+      return ;
+    }
+
+    /*
+     * Compute the time of an iteration during the current invocation.
+     * An invocation faster than the dispatch overhead has a negligible amount of work.
+     */
+    double parallelTime = time;
+    if (numCores > 1){
+      parallelTime -= NOELLE_DOALL_getDispatchOverhead(numCores) * numCores;
+      parallelTime = std::max(parallelTime, 1.0);
+    }
+    auto cost = (parallelTime * numCores) / numberOfIterations;
+
+    /*
+     * Update the cost of the loop.
+     */
+    auto oldCost = loopCost->nanosecondsPerIteration.load(std::memory_order_relaxed);
+    auto newCost = (oldCost <= 0) ? cost : (0.75 * oldCost + 0.25 * cost);
+    loopCost->nanosecondsPerIteration.store(newCost, std::memory_order_relaxed);
+
+    return ;
+  }
+
+  DispatcherInfo NOELLE_DOALLDispatcher (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize
+    ){
+
+    /*
+     * The number of iterations is unknown.
+     */
+    return NOELLE_DOALLDispatcherWithIterations(parallelizedLoop, env, maxNumberOfCores, chunkSize, 0);
+  }
+
+  DispatcherInfo NOELLE_DOALLDispatcherWithIterations (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations
+    ){
+
+    /*
+     * Set the number of cores to use.
+     */
+    auto runtimeNumberOfCores = NOELLE_getNumberOfCores();
+    auto numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
+    auto loopCost = NOELLE_DOALL_isAdaptive() ? NOELLE_DOALL_getLoopCost((void *)parallelizedLoop) : nullptr;
+    numCores = NOELLE_DOALL_chooseNumberOfCores(loopCost, numCores, numberOfIterations);
+    #ifdef RUNTIME_PRINT
+    std::cerr << "Starting dispatcher: num cores " << numCores << ", chunk size: " << chunkSize << std::endl;
+    #endif
+
+    /*
+     * Start profiling the invocation.
+     */
+    auto profile = NOELLE_profilerBegin("DOALL", numCores, 0);
+
+    /*
+     * Execute the invocation.
+     */
+    auto start = (loopCost != nullptr) ? NOELLE_profilerNow() : 0;
+    NOELLE_DOALLRun(parallelizedLoop, env, numCores, chunkSize, profile);
+    if (loopCost != nullptr){
+      NOELLE_DOALL_updateLoopCost(loopCost, numCores, numberOfIterations, NOELLE_profilerNow() - start);
+    }
+    NOELLE_profilerEnd(profile);
+
+    DispatcherInfo dispatcherInfo;
+    dispatcherInfo.numberOfThreadsUsed = numCores;
+    return dispatcherInfo;
+  }
+
+  #define NOELLE_DOALL_STATIC_SCHEDULE 0
+  #define NOELLE_DOALL_DYNAMIC_SCHEDULE 1
+  #define NOELLE_DOALL_GUIDED_SCHEDULE 2
+
+  typedef struct {
+    int64_t nextChunk;
+    int64_t endOfReservedChunks;
+    uint8_t padding[CACHE_LINE_SIZE - 2 * sizeof(int64_t)];
+  } DOALL_coreSchedule_t ;
+
+  typedef struct {
+    std::atomic<int64_t> nextChunk;
+    uint8_t padding[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    int64_t schedule;
+    int64_t numCores;
+    int64_t numberOfChunks;
+    DOALL_coreSchedule_t *cores;
+  } DOALL_schedule_t ;
+
+  typedef struct {
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t, void *) ;
+    void *env ;
+    int64_t coreID ;
+    int64_t numCores;
+    int64_t chunkSize ;
+    DOALL_schedule_t *schedule;
+    NOELLE_profilerInvocation_t *profile;
+  } DOALL_argsWithSchedule_t ;
+  static_assert(sizeof(DOALL_argsWithSchedule_t) <= NOELLE_TEAM_ARGUMENTS_SIZE, "DOALL arguments do not fit in a worker of the team");
+
+  static void NOELLE_DOALLTrampolineWithSchedule (void *args){
+
+    /*
+     * Fetch the arguments.
+     */
+    auto DOALLArgs = (DOALL_argsWithSchedule_t *) args;
+
+    /*
+     * Invoke
+     */
+    auto start = NOELLE_profilerTaskBegin(DOALLArgs->profile, DOALLArgs->coreID, nullptr);
+    DOALLArgs->parallelizedLoop(DOALLArgs->env, DOALLArgs->coreID, DOALLArgs->numCores, DOALLArgs->chunkSize, (void *)DOALLArgs->schedule);
+    NOELLE_profilerTaskEnd(DOALLArgs->profile, DOALLArgs->coreID, start);
+
+    return ;
+  }
+
+  static int64_t NOELLE_DOALL_getSchedule (int64_t compilerSchedule){
+
+    /*
+     * Fetch the schedule requested by the user (if any).
+     * The initialization of a static local variable is thread safe, so concurrent dispatchers never see a partially read schedule.
+     */
+    static const int64_t userSchedule = [](void) -> int64_t {
+      auto envVar = getenv("NOELLE_DOALL_SCHEDULE");
+      if (envVar == nullptr){
+        return -1;
+      }
+      std::string scheduleName{envVar};
+      if (scheduleName == "static"){
+        return NOELLE_DOALL_STATIC_SCHEDULE;
+      }
+      if (scheduleName == "dynamic"){
+        return NOELLE_DOALL_DYNAMIC_SCHEDULE;
+      }
+      if (scheduleName == "guided"){
+        return NOELLE_DOALL_GUIDED_SCHEDULE;
+      }
+      fprintf(stderr, "NOELLE: DOALL: WARNING = schedule \"%s\" is not supported. It will be ignored\n", envVar);
+
+      return -1;
+    }();
+
+    /*
+     * The schedule requested by the user has priority over the one chosen by the compiler.
+     */
+    if (userSchedule != -1){
+      return userSchedule;
+    }
+    return compilerSchedule;
+  }
+
+  static int64_t __attribute__((noinline)) NOELLE_DOALL_fetchNextChunk (
+    DOALL_schedule_t *schedule,
+    int64_t coreID
+    ){
+
+    /*
+     * Fetch the per-core information.
+     */
+    auto core = &schedule->cores[coreID];
+
+    switch (schedule->schedule){
+
+      case NOELLE_DOALL_STATIC_SCHEDULE: {
+
+        /*
+         * Chunks are assigned to cores in a round-robin way.
+         */
+        auto chunk = core->nextChunk;
+        core->nextChunk += schedule->numCores;
+        return chunk;
+      }
+
+      case NOELLE_DOALL_DYNAMIC_SCHEDULE:
+
+        /*
+         * Chunks are assigned to cores on demand.
+         */
+        return schedule->nextChunk.fetch_add(1, std::memory_order_relaxed);
+
+      case NOELLE_DOALL_GUIDED_SCHEDULE: {
+
+        /*
+         * Check if the core has chunks reserved already.
+         */
+        if (core->nextChunk < core->endOfReservedChunks){
+          return core->nextChunk++;
+        }
+
+        /*
+         * Reserve a new group of consecutive chunks.
+         * Its size is proportional to the number of chunks left to execute.
+         * If the number of iterations of the loop is unknown, then we reserve one chunk at a time.
+         */
+        int64_t chunksToReserve = 1;
+        if (schedule->numberOfChunks > 0){
+          auto chunksLeft = schedule->numberOfChunks - schedule->nextChunk.load(std::memory_order_relaxed);
+          chunksToReserve = std::max(chunksLeft / schedule->numCores, (int64_t)1);
+        }
+        auto chunk = schedule->nextChunk.fetch_add(chunksToReserve, std::memory_order_relaxed);
+        core->nextChunk = chunk + 1;
+        core->endOfReservedChunks = chunk + chunksToReserve;
+        return chunk;
+      }
+
+      default:
+        fprintf(stderr, "NOELLE: DOALL: ERROR = schedule %lld is not supported\n", (long long)schedule->schedule);
+        abort();
+    }
+  }
+
+  int64_t NOELLE_DOALL_nextChunk (
+    void *schedule,
+    int64_t coreID,
+    int64_t currentChunk,
+    bool isChunkCompleted
+    ){
+
+    /*
+     * Check if we need a new chunk.
+     */
+    if (!isChunkCompleted){
+      return currentChunk;
+    }
+
+    return NOELLE_DOALL_fetchNextChunk((DOALL_schedule_t *)schedule, coreID);
+  }
+
+  DispatcherInfo NOELLE_DOALLDispatcherWithSchedule (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t, void *), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t schedule,
+    int64_t numberOfIterations
+    ){
+
+    /*
+     * Set the number of cores to use.
+     */
+    auto runtimeNumberOfCores = NOELLE_getNumberOfCores();
+    auto numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
+    auto loopCost = NOELLE_DOALL_isAdaptive() ? NOELLE_DOALL_getLoopCost((void *)parallelizedLoop) : nullptr;
+    numCores = NOELLE_DOALL_chooseNumberOfCores(loopCost, numCores, numberOfIterations);
+    auto start = (loopCost != nullptr) ? NOELLE_profilerNow() : 0;
+    #ifdef RUNTIME_PRINT
+    std::cerr << "Starting dispatcher: num cores " << numCores << ", chunk size: " << chunkSize << ", schedule: " << schedule << std::endl;
+    #endif
+
+    /*
+     * Start profiling the invocation.
+     */
+    auto profile = NOELLE_profilerBegin("DOALL", numCores, 0);
+
+    /*
+     * Check if we can use the team of workers.
+     * Sequential invocations are executed by the current thread.
+     */
+    auto isSequential = (numCores == 1);
+    auto useTeam = (!isSequential) && NOELLE_teamAcquire(numCores);
+
+    /*
+     * Initialize the schedule shared among the cores.
+     */
+    DOALL_schedule_t loopSchedule;
+    loopSchedule.nextChunk.store(0, std::memory_order_relaxed);
+    loopSchedule.schedule = NOELLE_DOALL_getSchedule(schedule);
+    loopSchedule.numCores = numCores;
+    loopSchedule.numberOfChunks = (numberOfIterations + chunkSize - 1) / chunkSize;
+    if (useTeam){
+      loopSchedule.cores = (DOALL_coreSchedule_t *) NOELLE_teamScratchMemory(sizeof(DOALL_coreSchedule_t) * numCores);
+    } else {
+      posix_memalign((void **)&loopSchedule.cores, CACHE_LINE_SIZE, sizeof(DOALL_coreSchedule_t) * numCores);
+    }
+    for (auto i = 0; i < numCores; ++i) {
+      auto coreSchedule = &loopSchedule.cores[i];
+      coreSchedule->nextChunk = i;
+      coreSchedule->endOfReservedChunks = 0;
+    }
+
+    /*
+     * Prepare the arguments.
+     * The team of workers already has the memory for them.
+     */
+    DOALL_argsWithSchedule_t argsForTheFirstCore;
+    DOALL_argsWithSchedule_t *argsForAllCores = nullptr;
+    if (  (!useTeam)
+          && (!isSequential)  ){
+      posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(DOALL_argsWithSchedule_t) * numCores);
+    }
+    for (auto i = 0; i < numCores; ++i) {
+      DOALL_argsWithSchedule_t *argsPerCore;
+      if (useTeam){
+        argsPerCore = (i == 0) ? &argsForTheFirstCore : (DOALL_argsWithSchedule_t *) NOELLE_teamArgumentsOfTask(i);
+      } else if (isSequential){
+        argsPerCore = &argsForTheFirstCore;
+      } else {
+        argsPerCore = &argsForAllCores[i];
+      }
+      argsPerCore->parallelizedLoop = parallelizedLoop;
+      argsPerCore->env = env;
+      argsPerCore->coreID = i;
+      argsPerCore->numCores = numCores;
+      argsPerCore->chunkSize = chunkSize;
+      argsPerCore->schedule = &loopSchedule;
+      argsPerCore->profile = profile;
+    }
+
+    /*
+     * Run the DOALL tasks on the team of workers or on the current thread.
+     */
+    if (  (useTeam)
+          || (isSequential)  ){
+      for (auto i = 1; i < numCores; ++i) {
+        NOELLE_teamStartTask(i, NOELLE_DOALLTrampolineWithSchedule);
+      }
+      NOELLE_DOALLTrampolineWithSchedule(&argsForTheFirstCore);
+      if (useTeam){
+        NOELLE_teamJoin();
+      } else {
+        free(loopSchedule.cores);
+      }
+      if (loopCost != nullptr){
+        NOELLE_DOALL_updateLoopCost(loopCost, numCores, numberOfIterations, NOELLE_profilerNow() - start);
+      }
+      NOELLE_profilerEnd(profile);
+
+      DispatcherInfo dispatcherInfo;
+      dispatcherInfo.numberOfThreadsUsed = numCores;
+      return dispatcherInfo;
+    }
+
+    /*
+     * Submit DOALL tasks.
+     */
+    std::vector<MARC::TaskFuture<void>> localFutures;
+    for (auto i = 0; i < numCores; ++i) {
+      localFutures.push_back(pool.submit(NOELLE_DOALLTrampolineWithSchedule, &argsForAllCores[i]));
+      #ifdef RUNTIME_PRINT
+      std::cerr << "Submitted DOALL task on core " << i << std::endl;
+      #endif
+    }
+
+    /*
+     * Wait for DOALL tasks.
+     */
+    for (auto& future : localFutures){
+      future.get();
+    }
+    #ifdef RUNTIME_PRINT
+    std::cerr << "Got all futures" << std::endl;
+    #endif
+    if (loopCost != nullptr){
+      NOELLE_DOALL_updateLoopCost(loopCost, numCores, numberOfIterations, NOELLE_profilerNow() - start);
+    }
+    NOELLE_profilerEnd(profile);
+
+    /*
+     * Free the memory.
+     */
+    free(loopSchedule.cores);
+    free(argsForAllCores);
+
+    DispatcherInfo dispatcherInfo;
+    dispatcherInfo.numberOfThreadsUsed = numCores;
+    return dispatcherInfo;
+  }
+
+  #ifdef RUNTIME_PRINT
+  void *mySSGlobal = nullptr;
+  #endif
+
+
+  /**********************************************************************
+   *                HELIX
+   *
+   * Sequential segments are synchronized by monotonic counters.
+   * Every core counts how many times it entered each sequential segment.
+   * To signal the next core, a core stores its counter into the entry of the sequential segment of the next core (a plain store followed by a fence; no locked read-modify-write is needed).
+   * To wait, a core waits for the entry of its own sequential segment to reach the number of times it entered it (plus one if it is not the first core).
+   * Signaling twice in the same iteration is therefore harmless.
+   *
+   * The fast paths (HELIX_wait and HELIX_signal) are inlined in the tasks by the compiler.
+   * A core that has to wait spins with an exponential backoff and it then sleeps on a futex.
+   **********************************************************************/
+  #define HELIX_SPIN_ITERATIONS (1 << 12)
+  #define HELIX_MAX_BACKOFF 64
+  #define HELIX_SLEEP_NANOSECONDS 100000
+
+  typedef struct {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> iterations;
+    std::atomic<uint32_t> isWaiting;
+  } HELIX_sequentialSegment_t ;
+  static_assert(sizeof(HELIX_sequentialSegment_t) == CACHE_LINE_SIZE, "A sequential segment must fit a cache line");
+
+  static inline bool HELIX_hasReached (uint32_t iterations, uint64_t iteration){
+
+    /*
+     * Counters wrap around; cores are never more than one iteration apart from each other.
+     */
+    return ((int32_t)(iterations - ((uint32_t)iteration))) >= 0;
+  }
+
+  static void __attribute__((noinline)) HELIX_waitForIteration (HELIX_sequentialSegment_t *ss, uint64_t iteration){
+
+    /*
+     * Spin with an exponential backoff.
+     */
+    auto profile = NOELLE_profilerCurrentThread;
+    auto start = (profile != nullptr) ? NOELLE_profilerNow() : 0;
+    uint32_t backoff = 1;
+    for (uint32_t spins = 0; spins < HELIX_SPIN_ITERATIONS; spins += backoff){
+      for (uint32_t i = 0; i < backoff; i++){
+        NOELLE_CPU_RELAX();
+      }
+      if (HELIX_hasReached(ss->iterations.load(std::memory_order_acquire), iteration)){
+        if (profile != nullptr){
+          NOELLE_profilerWaited(profile, ss, start);
+        }
+        return ;
+      }
+      backoff = std::min(backoff * 2, (uint32_t)HELIX_MAX_BACKOFF);
     }
-    #ifdef RUNTIME_PRINT
-    std::cerr << "Got all futures" << std::endl;
-    #endif
 
     /*
-     * Free the memory.
+     * Sleep on a futex.
+     * The fence orders the store to isWaiting before the load of iterations; HELIX_signal does the opposite.
+     * Hence, either the signaller sees that we are waiting and wakes us up, or we see its new counter (here or in the futex system call).
+     * The timeout is only a safety net.
      */
-    free(argsForAllCores);
+    struct timespec timeout = {0, HELIX_SLEEP_NANOSECONDS};
+    ss->isWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (true){
+      auto iterations = ss->iterations.load();
+      if (HELIX_hasReached(iterations, iteration)){
+        break ;
+      }
+      syscall(SYS_futex, (uint32_t *)&ss->iterations, FUTEX_WAIT_PRIVATE, iterations, &timeout, nullptr, 0);
+    }
+    ss->isWaiting.store(0, std::memory_order_relaxed);
+    if (profile != nullptr){
+      NOELLE_profilerWaited(profile, ss, start);
+    }
 
-    DispatcherInfo dispatcherInfo;
-    dispatcherInfo.numberOfThreadsUsed = numCores;
-    return dispatcherInfo;
+    return ;
   }
 
-  #ifdef RUNTIME_PRINT
-  void *mySSGlobal = nullptr;
-  #endif
+  static void __attribute__((noinline)) HELIX_wakeUp (HELIX_sequentialSegment_t *ss){
+    syscall(SYS_futex, (uint32_t *)&ss->iterations, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
 
+    return ;
+  }
 
-  /**********************************************************************
-   *                HELIX
-   **********************************************************************/
   typedef struct {
     void (*parallelizedLoop)(void *, void *, void *, void *, int64_t, int64_t, uint64_t *);
     void *env ;
@@ -282,7 +1608,9 @@ extern "C" {
     uint64_t coreID;
     uint64_t numCores;
     uint64_t *loopIsOverFlag;
+    NOELLE_profilerInvocation_t *profile;
   } NOELLE_HELIX_args_t ;
+  static_assert(sizeof(NOELLE_HELIX_args_t) <= NOELLE_TEAM_ARGUMENTS_SIZE, "HELIX arguments do not fit in a worker of the team");
 
   void NOELLE_HELIXTrampoline (void *args){
 
@@ -294,6 +1622,7 @@ extern "C" {
     /*
      * Invoke
      */
+    auto start = NOELLE_profilerTaskBegin(HELIX_args->profile, HELIX_args->coreID, HELIX_args->ssArrayPast);
     HELIX_args->parallelizedLoop(
       HELIX_args->env, 
       HELIX_args->loopCarriedArray, 
@@ -303,30 +1632,7 @@ extern "C" {
       HELIX_args->numCores,
       HELIX_args->loopIsOverFlag
       );
-
-    return ;
-  }
-
-  void HELIX_helperThread (void *ssArray, uint32_t numOfsequentialSegments, uint64_t *theLoopIsOver){
-
-    while ((*theLoopIsOver) == 0){
-
-      /*
-       * Prefetch all sequential segment cache lines of the current loop iteration.
-       */
-      for (auto i = 0 ; ((*theLoopIsOver) == 0) && (i < numOfsequentialSegments); i++){
-
-        /*
-         * Fetch the pointer.
-         */
-        auto ptr = (uint64_t *)(((uint64_t)ssArray) + (i * CACHE_LINE_SIZE));
-
-        /*
-         * Prefetch the cache line for the current sequential segment.
-         */
-        while (((*theLoopIsOver) == 0) && ((*ptr) == 0)) ;
-      }
-    }
+    NOELLE_profilerTaskEnd(HELIX_args->profile, HELIX_args->coreID, start);
 
     return ;
   }
@@ -351,20 +1657,34 @@ extern "C" {
     assert(env != NULL);
     assert(numCores > 1);
 
+    /*
+     * Start profiling the invocation.
+     */
+    auto profile = NOELLE_profilerBegin("HELIX", numCores, numOfsequentialSegments);
+
+    /*
+     * Check if we can use the team of workers.
+     */
+    auto useTeam = NOELLE_teamAcquire(numCores);
+
     /*
      * Allocate the sequential segment arrays.
      * We need numCores - 1 arrays.
      */
     auto numOfSSArrays = numCores;
     void *ssArrays = NULL;
-    auto ssSize = CACHE_LINE_SIZE;
+    auto ssSize = sizeof(HELIX_sequentialSegment_t);
     auto ssArraySize = ssSize * numOfsequentialSegments;
     if (numOfsequentialSegments > 0){
 
       /*
        * Allocate the sequential segment arrays.
        */
-      posix_memalign(&ssArrays, CACHE_LINE_SIZE, ssArraySize *  numOfSSArrays);
+      if (useTeam){
+        ssArrays = NOELLE_teamScratchMemory(ssArraySize * numOfSSArrays);
+      } else {
+        posix_memalign(&ssArrays, CACHE_LINE_SIZE, ssArraySize *  numOfSSArrays);
+      }
       if (ssArrays == NULL){
         fprintf(stderr, "HELIX: dispatcher: ERROR = not enough memory to allocate %lld sequential segment arrays\n", (long long)numCores);
         abort();
@@ -372,36 +1692,12 @@ extern "C" {
 
       /*
        * Initialize the sequential segment arrays.
+       * No core has entered any sequential segment yet.
        */
-      for (auto i = 0; i < numOfSSArrays; i++){
-
-        /*
-         * Fetch the current sequential segment array.
-         */
-        auto ssArray = (void *)(((uint64_t)ssArrays) + (i * ssArraySize));
-
-        /*
-         * Initialize the locks.
-         */
-        for (auto lockID = 0; lockID < numOfsequentialSegments; lockID++){
-
-          /*
-           * Fetch the pointer to the current lock.
-           */
-          auto lock = (pthread_spinlock_t *)(((uint64_t)ssArray) + (lockID * ssSize));
-
-          /*
-           * Initialize the lock.
-           */
-          pthread_spin_init(lock, PTHREAD_PROCESS_PRIVATE);
-
-          /*
-           * If the sequential segment is not for core 0, then we need to lock it.
-           */
-          if (i > 0){
-            pthread_spin_lock(lock);
-          }
-        }
+      auto sequentialSegments = (HELIX_sequentialSegment_t *) ssArrays;
+      for (auto i = 0; i < (numOfSSArrays * numOfsequentialSegments); i++){
+        sequentialSegments[i].iterations.store(0, std::memory_order_relaxed);
+        sequentialSegments[i].isWaiting.store(0, std::memory_order_relaxed);
       }
     }
 
@@ -411,9 +1707,13 @@ extern "C" {
 
     /*
      * Allocate the arguments for the cores.
+     * The team of workers already has the memory for them.
      */
-    NOELLE_HELIX_args_t *argsForAllCores;
-    posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(NOELLE_HELIX_args_t) * numCores);
+    NOELLE_HELIX_args_t *argsForAllCores = nullptr;
+    NOELLE_HELIX_args_t argsForTheFirstCore;
+    if (!useTeam){
+      posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(NOELLE_HELIX_args_t) * numCores);
+    }
 
     /*
      * Launch threads
@@ -445,7 +1745,12 @@ extern "C" {
       /*
        * Prepare the arguments.
        */
-      auto argsPerCore = &argsForAllCores[i];
+      NOELLE_HELIX_args_t *argsPerCore;
+      if (useTeam){
+        argsPerCore = (i == 0) ? &argsForTheFirstCore : (NOELLE_HELIX_args_t *) NOELLE_teamArgumentsOfTask(i);
+      } else {
+        argsPerCore = &argsForAllCores[i];
+      }
       argsPerCore->parallelizedLoop = parallelizedLoop;
       argsPerCore->env = env;
       argsPerCore->loopCarriedArray = loopCarriedArray;
@@ -454,42 +1759,42 @@ extern "C" {
       argsPerCore->coreID = i;
       argsPerCore->numCores = numCores;
       argsPerCore->loopIsOverFlag = &loopIsOverFlag;
+      argsPerCore->profile = profile;
 
       /*
-       * Set the affinity for both the thread and its helper.
+       * Workers of the team are already pinned.
+       * The first task is executed by the current thread after starting all the others.
        */
-      CPU_ZERO(&cores);
-      auto physicalCore = i * 2;
-      CPU_SET(physicalCore, &cores);
-      CPU_SET(physicalCore + 1, &cores);
+      if (useTeam){
+        if (i > 0){
+          NOELLE_teamStartTask(i, NOELLE_HELIXTrampoline);
+        }
+        continue ;
+      }
 
       /*
-       * Launch the thread.
+       * Set the affinity of the thread: all logical cores of the same physical core.
        */
-      //localFutures.push_back(pool.submitToCores(cores, NOELLE_HELIXTrampoline, argsPerCore));
-      localFutures.push_back(pool.submitToCores(
-        cores,
-        argsPerCore->parallelizedLoop,
-        argsPerCore->env, 
-        argsPerCore->loopCarriedArray,
-        argsPerCore->ssArrayPast, 
-        argsPerCore->ssArrayFuture,
-        argsPerCore->coreID, 
-        argsPerCore->numCores,
-        argsPerCore->loopIsOverFlag
-      ));
+      CPU_ZERO(&cores);
+      NOELLE_setPhysicalCoreOfSlot(i, &cores);
 
       /*
-       * Launch the helper thread.
+       * Launch the thread.
        */
-      continue ;
-      localFutures.push_back(pool.submitToCores(
-        cores,
-        HELIX_helperThread, 
-        ssArrayPast,
-        numOfsequentialSegments,
-        &loopIsOverFlag
-      ));
+      localFutures.push_back(pool.submitToCores(cores, NOELLE_HELIXTrampoline, argsPerCore));
+    }
+
+    /*
+     * Execute the first task and wait for the team of workers.
+     */
+    if (useTeam){
+      NOELLE_HELIXTrampoline(&argsForTheFirstCore);
+      NOELLE_teamJoin();
+      NOELLE_profilerEnd(profile);
+
+      DispatcherInfo dispatcherInfo;
+      dispatcherInfo.numberOfThreadsUsed = numCores;
+      return dispatcherInfo;
     }
 
     #ifdef RUNTIME_PRINT
@@ -512,10 +1817,13 @@ extern "C" {
     std::cerr << "Got all futures\n";
     #endif
 
+    NOELLE_profilerEnd(profile);
+
     /*
      * Free the memory.
      */
     free(ssArrays);
+    free(argsForAllCores);
 
     DispatcherInfo dispatcherInfo;
     dispatcherInfo.numberOfThreadsUsed = numCores;
@@ -523,13 +1831,14 @@ extern "C" {
   }
 
   void HELIX_wait (
-    void *sequentialSegment
+    void *sequentialSegment,
+    uint64_t iteration
     ){
 
     /*
-     * Fetch the spinlock
+     * Fetch the sequential segment.
      */
-    auto ss = (pthread_spinlock_t *) sequentialSegment;
+    auto ss = (HELIX_sequentialSegment_t *) sequentialSegment;
 
     #ifdef RUNTIME_PRINT
     assert(ss != NULL);
@@ -537,9 +1846,11 @@ extern "C" {
     #endif
 
     /*
-     * Wait
+     * Wait for the previous core to complete the iteration @iteration of the sequential segment.
      */
-    pthread_spin_lock(ss);
+    if (!HELIX_hasReached(ss->iterations.load(std::memory_order_acquire), iteration)){
+      HELIX_waitForIteration(ss, iteration);
+    }
 
     #ifdef RUNTIME_PRINT
     fprintf(stderr, "HelixDispatcher: Waited on sequential segment: %ld\n", (int *)sequentialSegment - (int *)mySSGlobal);
@@ -549,13 +1860,14 @@ extern "C" {
   }
 
   void HELIX_signal (
-    void *sequentialSegment
+    void *sequentialSegment,
+    uint64_t iteration
     ){
 
     /*
-     * Fetch the spinlock
+     * Fetch the sequential segment.
      */
-    auto ss = (pthread_spinlock_t *) sequentialSegment;
+    auto ss = (HELIX_sequentialSegment_t *) sequentialSegment;
 
     #ifdef RUNTIME_PRINT
     assert(ss != NULL);
@@ -563,9 +1875,13 @@ extern "C" {
     #endif
 
     /*
-     * Signal
+     * Signal that the current core has completed the iteration @iteration of the sequential segment.
      */
-    pthread_spin_unlock(ss);
+    ss->iterations.store((uint32_t)iteration, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ss->isWaiting.load(std::memory_order_relaxed)){
+      HELIX_wakeUp(ss);
+    }
 
     #ifdef RUNTIME_PRINT
     fprintf(stderr, "HelixDispatcher: Signaled on sequential segment: %ld\n", (int *)sequentialSegment - (int *)mySSGlobal);
@@ -575,6 +1891,312 @@ extern "C" {
   }
 
 
+  /**********************************************************************
+   *                QUEUES
+   *
+   * DSWP stages communicate through bounded single-producer/single-consumer ring buffers.
+   * The producer and the consumer work on private copies of the indices and publish them only once per cache line of elements.
+   * Hence, the cache lines that hold the shared indices move between the two cores once per cache line of elements rather than once per element.
+   *
+   * A thread must never wait while it holds elements (or free slots) it has not published yet; otherwise, stages could wait for each other forever.
+   * Therefore, every thread keeps track of the queues it has not published yet, and it publishes all of them before waiting and at the end of a stage.
+   **********************************************************************/
+  #define NOELLE_QUEUE_BYTES (CACHE_LINE_SIZE * 256)
+  #define NOELLE_QUEUE_SPIN_ITERATIONS (1 << 10)
+  #define NOELLE_QUEUE_MAX_PENDING 64
+
+  typedef struct {
+
+    /*
+     * Fields used only by the producer.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t tail;
+    uint64_t cachedHead;
+    bool isProducerPending;
+    bool isProfiled;
+    uint64_t pushStalls;
+    uint64_t occupancy;
+    uint64_t occupancySamples;
+
+    /*
+     * Fields used only by the consumer.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t head;
+    uint64_t cachedTail;
+    bool isConsumerPending;
+    uint64_t popStalls;
+
+    /*
+     * Published indices.
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> publishedTail;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> publishedHead;
+
+    /*
+     * Elements.
+     */
+    alignas(CACHE_LINE_SIZE) uint8_t buffer[NOELLE_QUEUE_BYTES];
+  } NOELLE_queue_t;
+
+  typedef struct {
+    uint32_t numberOfQueues;
+    NOELLE_queue_t *queues[NOELLE_QUEUE_MAX_PENDING];
+    bool isProducer[NOELLE_QUEUE_MAX_PENDING];
+  } NOELLE_queuesPending_t;
+
+  static thread_local NOELLE_queuesPending_t NOELLE_queuesPending;
+
+  static NOELLE_queue_t * NOELLE_queueCreate (bool isProfiled){
+    NOELLE_queue_t *queue;
+    posix_memalign((void **)&queue, CACHE_LINE_SIZE, sizeof(NOELLE_queue_t));
+    queue->tail = 0;
+    queue->cachedHead = 0;
+    queue->isProducerPending = false;
+    queue->isProfiled = isProfiled;
+    queue->pushStalls = 0;
+    queue->occupancy = 0;
+    queue->occupancySamples = 0;
+    queue->head = 0;
+    queue->cachedTail = 0;
+    queue->isConsumerPending = false;
+    queue->popStalls = 0;
+    queue->publishedTail.store(0);
+    queue->publishedHead.store(0);
+
+    return queue;
+  }
+
+  /*
+   * Publish the indices of all queues the current thread has not published yet.
+   */
+  static void __attribute__((noinline)) NOELLE_queuesPublish (void){
+    for (uint32_t i = 0; i < NOELLE_queuesPending.numberOfQueues; i++){
+      auto queue = NOELLE_queuesPending.queues[i];
+      if (NOELLE_queuesPending.isProducer[i]){
+        queue->publishedTail.store(queue->tail, std::memory_order_release);
+        queue->isProducerPending = false;
+      } else {
+        queue->publishedHead.store(queue->head, std::memory_order_release);
+        queue->isConsumerPending = false;
+      }
+    }
+    NOELLE_queuesPending.numberOfQueues = 0;
+
+    return ;
+  }
+
+  static void __attribute__((noinline)) NOELLE_queueIsPending (NOELLE_queue_t *queue, bool isProducer){
+    if (NOELLE_queuesPending.numberOfQueues == NOELLE_QUEUE_MAX_PENDING){
+      NOELLE_queuesPublish();
+    }
+    auto i = NOELLE_queuesPending.numberOfQueues++;
+    NOELLE_queuesPending.queues[i] = queue;
+    NOELLE_queuesPending.isProducer[i] = isProducer;
+    if (isProducer){
+      queue->isProducerPending = true;
+    } else {
+      queue->isConsumerPending = true;
+    }
+
+    return ;
+  }
+
+  static void NOELLE_queueBackoff (uint32_t iteration){
+    if (iteration < NOELLE_QUEUE_SPIN_ITERATIONS){
+      NOELLE_CPU_RELAX();
+    } else {
+      sched_yield();
+    }
+
+    return ;
+  }
+
+  static void __attribute__((noinline)) NOELLE_queueWaitForSpace (NOELLE_queue_t *queue, uint64_t capacity){
+
+    /*
+     * Check if the consumer has freed some slots.
+     */
+    queue->cachedHead = queue->publishedHead.load(std::memory_order_acquire);
+    if ((queue->tail - queue->cachedHead) < capacity){
+      return ;
+    }
+
+    /*
+     * Wait.
+     */
+    queue->pushStalls++;
+    NOELLE_queuesPublish();
+    for (uint32_t iteration = 0; (queue->tail - queue->cachedHead) == capacity; iteration++){
+      NOELLE_queueBackoff(iteration);
+      queue->cachedHead = queue->publishedHead.load(std::memory_order_acquire);
+    }
+
+    return ;
+  }
+
+  static void __attribute__((noinline)) NOELLE_queueWaitForElements (NOELLE_queue_t *queue){
+
+    /*
+     * Check if the producer has published new elements.
+     */
+    queue->cachedTail = queue->publishedTail.load(std::memory_order_acquire);
+    if (queue->head != queue->cachedTail){
+      return ;
+    }
+
+    /*
+     * Wait.
+     */
+    queue->popStalls++;
+    NOELLE_queuesPublish();
+    for (uint32_t iteration = 0; queue->head == queue->cachedTail; iteration++){
+      NOELLE_queueBackoff(iteration);
+      queue->cachedTail = queue->publishedTail.load(std::memory_order_acquire);
+    }
+
+    return ;
+  }
+
+  /*
+   * Templates cannot have C linkage.
+   */
+  extern "C++" {
+
+  template <typename T>
+  static inline void NOELLE_queuePush (NOELLE_queue_t *queue, T value){
+    constexpr uint64_t capacity = NOELLE_QUEUE_BYTES / sizeof(T);
+    constexpr uint64_t elementsPerCacheLine = CACHE_LINE_SIZE / sizeof(T);
+
+    /*
+     * Wait for a free slot.
+     */
+    auto tail = queue->tail;
+    if ((tail - queue->cachedHead) == capacity){
+      NOELLE_queueWaitForSpace(queue, capacity);
+    }
+
+    /*
+     * Store the element.
+     */
+    ((T *)queue->buffer)[tail & (capacity - 1)] = value;
+    tail++;
+    queue->tail = tail;
+
+    /*
+     * Publish a full cache line of elements.
+     * If the queue is profiled, then its occupancy is sampled at the same time.
+     */
+    if ((tail & (elementsPerCacheLine - 1)) == 0){
+      queue->publishedTail.store(tail, std::memory_order_release);
+      if (queue->isProfiled){
+        queue->occupancy += tail - queue->publishedHead.load(std::memory_order_relaxed);
+        queue->occupancySamples++;
+      }
+    } else if (!queue->isProducerPending){
+      NOELLE_queueIsPending(queue, true);
+    }
+
+    return ;
+  }
+
+  template <typename T>
+  static inline T NOELLE_queuePop (NOELLE_queue_t *queue){
+    constexpr uint64_t capacity = NOELLE_QUEUE_BYTES / sizeof(T);
+    constexpr uint64_t elementsPerCacheLine = CACHE_LINE_SIZE / sizeof(T);
+
+    /*
+     * Wait for an element.
+     */
+    auto head = queue->head;
+    if (head == queue->cachedTail){
+      NOELLE_queueWaitForElements(queue);
+    }
+
+    /*
+     * Load the element.
+     */
+    auto value = ((T *)queue->buffer)[head & (capacity - 1)];
+    head++;
+    queue->head = head;
+
+    /*
+     * Release a full cache line of slots.
+     */
+    if ((head & (elementsPerCacheLine - 1)) == 0){
+      queue->publishedHead.store(head, std::memory_order_release);
+    } else if (!queue->isConsumerPending){
+      NOELLE_queueIsPending(queue, false);
+    }
+
+    return value;
+  }
+
+  }
+
+  void queuePush8(NOELLE_queue_t *queue, int8_t *val) { 
+    NOELLE_queuePush(queue, *val); 
+
+    #ifdef DSWP_STATS
+    numberOfPushes8++;
+    #endif
+
+    return ;
+  }
+
+  void queuePop8(NOELLE_queue_t *queue, int8_t *val) { 
+    *val = NOELLE_queuePop<int8_t>(queue); 
+    return ;
+  }
+
+  void queuePush16(NOELLE_queue_t *queue, int16_t *val) { 
+    NOELLE_queuePush(queue, *val); 
+
+    #ifdef DSWP_STATS
+    numberOfPushes16++;
+    #endif
+
+    return ;
+  }
+
+  void queuePop16(NOELLE_queue_t *queue, int16_t *val) { 
+    *val = NOELLE_queuePop<int16_t>(queue);
+
+    return ;
+  }
+
+  void queuePush32(NOELLE_queue_t *queue, int32_t *val) { 
+    NOELLE_queuePush(queue, *val); 
+
+    #ifdef DSWP_STATS
+    numberOfPushes32++;
+    #endif
+
+    return ;
+  }
+
+  void queuePop32(NOELLE_queue_t *queue, int32_t *val) { 
+    *val = NOELLE_queuePop<int32_t>(queue);
+
+    return ;
+  }
+
+  void queuePush64(NOELLE_queue_t *queue, int64_t *val) { 
+    NOELLE_queuePush(queue, *val); 
+
+    #ifdef DSWP_STATS
+    numberOfPushes64++;
+    #endif
+
+    return ;
+  }
+
+  void queuePop64(NOELLE_queue_t *queue, int64_t *val) { 
+    *val = NOELLE_queuePop<int64_t>(queue); 
+
+    return ;
+  }
+
+
   /**********************************************************************
    *                DSWP
    **********************************************************************/
@@ -582,7 +2204,10 @@ extern "C" {
     stageFunctionPtr_t funcToInvoke;
     void *env;
     void *localQueues;
+    int64_t stageID;
+    NOELLE_profilerInvocation_t *profile;
   } NOELLE_DSWP_args_t ;
+  static_assert(sizeof(NOELLE_DSWP_args_t) <= NOELLE_TEAM_ARGUMENTS_SIZE, "DSWP arguments do not fit in a worker of the team");
 
   void stageExecuter(void (*stage)(void *, void *), void *env, void *queues){ 
     return stage(env, queues);
@@ -598,8 +2223,15 @@ extern "C" {
     /*
      * Invoke
      */
+    auto start = NOELLE_profilerTaskBegin(DSWPArgs->profile, DSWPArgs->stageID, nullptr);
     DSWPArgs->funcToInvoke(DSWPArgs->env, DSWPArgs->localQueues);
 
+    /*
+     * Publish the elements pushed by the last iterations of the stage.
+     */
+    NOELLE_queuesPublish();
+    NOELLE_profilerTaskEnd(DSWPArgs->profile, DSWPArgs->stageID, start);
+
     return ;
   }
 
@@ -615,19 +2247,11 @@ extern "C" {
     for (auto i = 0; i < numberOfQueues; ++i) {
       switch (queueSizes[i]) {
         case 1:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
-          break;
         case 8:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
-          break;
         case 16:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int16_t>();
-          break;
         case 32:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int32_t>();
-          break;
         case 64:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int64_t>();
+          localQueues[i] = NOELLE_queueCreate(NOELLE_profilerIsEnabled());
           break;
         default:
           std::cerr << "QUEUE SIZE INCORRECT!\n";
@@ -639,10 +2263,25 @@ extern "C" {
     std::cerr << "Made queues" << std::endl;
     #endif
 
+    /*
+     * Start profiling the invocation.
+     */
+    auto profile = NOELLE_profilerBegin("DSWP", numberOfStages, 0);
+
+    /*
+     * Check if we can use the team of workers.
+     */
+    auto useTeam = NOELLE_teamAcquire(numberOfStages);
+
     /*
      * Allocate the memory to store the arguments.
+     * The team of workers already has the memory for them.
      */
-    auto argsForAllCores = (NOELLE_DSWP_args_t *) malloc(sizeof(NOELLE_DSWP_args_t) * numberOfStages);
+    NOELLE_DSWP_args_t *argsForAllCores = nullptr;
+    NOELLE_DSWP_args_t argsForTheFirstStage;
+    if (!useTeam){
+      argsForAllCores = (NOELLE_DSWP_args_t *) malloc(sizeof(NOELLE_DSWP_args_t) * numberOfStages);
+    }
 
     /*
      * Submit DSWP tasks
@@ -654,10 +2293,27 @@ extern "C" {
       /*
        * Prepare the arguments.
        */
-      auto argsPerCore = &argsForAllCores[i];
+      NOELLE_DSWP_args_t *argsPerCore;
+      if (useTeam){
+        argsPerCore = (i == 0) ? &argsForTheFirstStage : (NOELLE_DSWP_args_t *) NOELLE_teamArgumentsOfTask(i);
+      } else {
+        argsPerCore = &argsForAllCores[i];
+      }
       argsPerCore->funcToInvoke = reinterpret_cast<stageFunctionPtr_t>(reinterpret_cast<long long>(allStages[i]));
       argsPerCore->env = env;
       argsPerCore->localQueues = (void *) localQueues;
+      argsPerCore->stageID = i;
+      argsPerCore->profile = profile;
+
+      /*
+       * The first stage is executed by the current thread after starting all the others.
+       */
+      if (useTeam){
+        if (i > 0){
+          NOELLE_teamStartTask(i, NOELLE_DSWPTrampoline);
+        }
+        continue ;
+      }
 
       /*
        * Submit
@@ -671,6 +2327,14 @@ extern "C" {
     std::cerr << "Submitted pool" << std::endl;
     #endif
 
+    /*
+     * Execute the first stage and wait for the team of workers.
+     */
+    if (useTeam){
+      NOELLE_DSWPTrampoline(&argsForTheFirstStage);
+      NOELLE_teamJoin();
+    }
+
     /*
      * Wait for the tasks to complete.
      */
@@ -685,24 +2349,11 @@ extern "C" {
      * Free the memory.
      */
     for (int i = 0; i < numberOfQueues; ++i) {
-      switch (queueSizes[i]) {
-        case 1:
-          delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
-          break;
-        case 8:
-          delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
-          break;
-        case 16:
-          delete (ThreadSafeLockFreeQueue<int16_t> *)(localQueues[i]);
-          break;
-        case 32:
-          delete (ThreadSafeLockFreeQueue<int32_t> *)(localQueues[i]);
-          break;
-        case 64:
-          delete (ThreadSafeLockFreeQueue<int64_t> *)(localQueues[i]);
-          break;
-      }
+      auto queue = (NOELLE_queue_t *)localQueues[i];
+      NOELLE_profilerQueue(profile, i, NOELLE_profilerQueue_t{queue->pushStalls, queue->popStalls, queue->occupancy, queue->occupancySamples});
+      free(queue);
     }
+    NOELLE_profilerEnd(profile);
     free(argsForAllCores);
 
     #ifdef DSWP_STATS
@@ -46,10 +46,10 @@ bool SCCPartitionScheduler::squeezePartitions (void) {
         basicBlockToPartitionsMap[B].insert(partition);
       }
 
-      auto instructionsAfterI = reachabilityDFR->OUT(I);
-      for (auto J : instructionsAfterI) {
+      reachabilityDFR->iterateOverOUT(I, [&](Value *J) -> bool {
         reverseReachabilityMap[cast<Instruction>(J)].insert(I);
-      }
+        return false;
+      });
 
       return false;
     });
@@ -35,4 +35,14 @@ namespace llvm {
     MEMORY_CLONING_ID
   };
 
+  /*
+   * Policies to assign chunks of iterations of a DOALL loop to cores.
+   * The values must match the ones used by the runtime.
+   */
+  enum DOALLSchedule {
+    DOALL_STATIC_SCHEDULE,
+    DOALL_DYNAMIC_SCHEDULE,
+    DOALL_GUIDED_SCHEDULE
+  };
+
 }
@@ -54,18 +54,46 @@ namespace llvm::noelle {
        * DOALL specific generation
        */
       void rewireLoopToIterateChunks (
-        LoopDependenceInfo *LDI
+        LoopDependenceInfo *LDI,
+        DOALLSchedule schedule
       );
+
+      void fetchTheNextChunkOnlyAtChunkBoundaries (void) ;
       void addChunkFunctionExecutionAsideOriginalLoop (
         LoopDependenceInfo *LDI,
         Function *loopFunction,
-        Noelle &par
+        Noelle &par,
+        DOALLSchedule schedule
       );
 
       /*
        * Helpers
        */
       Value *fetchClone(Value *original) const ;
+
+      Value *createCallToFetchTheNextChunk (
+        IRBuilder<> &builder,
+        Value *currentChunkIndex,
+        Value *isChunkCompleted
+      ) const ;
+
+      Value *computeTheNumberOfIterations (
+        LoopDependenceInfo *LDI,
+        IRBuilder<> &builder,
+        Noelle &par
+      ) const ;
+
+      /*
+       * Runtime support for schedules that assign chunks to cores at runtime.
+       */
+      Function *taskDispatcherWithSchedule;
+      Function *nextChunkFetcher;
+      FunctionType *taskTypeWithSchedule;
+
+      /*
+       * Calls to the runtime that fetch the next chunk in the latches of the task, together with the condition of the current chunk being completed.
+       */
+      std::vector<std::pair<CallInst *, Value *>> nextChunkFetchesInLatches;
   };
 
 }
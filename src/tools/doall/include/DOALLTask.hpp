@@ -33,6 +33,12 @@ namespace llvm::noelle {
        */
       Value *coreArg, *numCoresArg, *chunkSizeArg;
 
+      /*
+       * Schedule of the chunks handled by the runtime.
+       * This is nullptr when chunks are statically assigned to cores.
+       */
+      Value *scheduleArg;
+
       /*
        * Clone of original IV loop, new outer loop
        */
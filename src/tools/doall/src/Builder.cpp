@@ -12,7 +12,8 @@
 #include "DOALLTask.hpp"
 
 void DOALL::rewireLoopToIterateChunks (
-  LoopDependenceInfo *LDI
+  LoopDependenceInfo *LDI,
+  DOALLSchedule schedule
   ){
 
   /*
@@ -50,9 +51,24 @@ void DOALL::rewireLoopToIterateChunks (
    */
   auto clonedStepSizeMap = cloneIVStepValueComputation(LDI, 0, entryBuilder);
 
+  /*
+   * Fetch the index of the first chunk executed by the task.
+   * For the static schedule, this is the core ID.
+   * Otherwise, the runtime assigns it.
+   */
+  auto isStaticallyScheduled = (schedule == DOALL_STATIC_SCHEDULE);
+  Value *firstChunkIndex = task->coreArg;
+  if (!isStaticallyScheduled){
+    firstChunkIndex = this->createCallToFetchTheNextChunk(
+      entryBuilder,
+      ConstantInt::get(chunkCounterType, -1, true),
+      ConstantInt::getTrue(entryBuilder.getContext())
+    );
+  }
+
   /*
    * Determine start value of the IV for the task
-   * core_start: original_start + original_step_size * core_id * chunk_size
+   * core_start: original_start + original_step_size * first_chunk_index * chunk_size
    */
   for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
     auto startOfIV = fetchClone(ivInfo->getStartValue());
@@ -62,7 +78,7 @@ void DOALL::rewireLoopToIterateChunks (
     auto nthCoreOffset = entryBuilder.CreateMul(
       stepOfIV,
       entryBuilder.CreateZExtOrTrunc(
-        entryBuilder.CreateMul(task->coreArg, task->chunkSizeArg, "coreIdx_X_chunkSize"),
+        entryBuilder.CreateMul(firstChunkIndex, task->chunkSizeArg, "coreIdx_X_chunkSize"),
         stepOfIV->getType()
       ),
       "stepSize_X_coreIdx_X_chunkSize"
@@ -76,26 +92,72 @@ void DOALL::rewireLoopToIterateChunks (
    * Determine additional step size from the beginning of the next core's chunk
    * to the start of this core's next chunk
    * chunk_step_size: original_step_size * (num_cores - 1) * chunk_size
+   *
+   * When the runtime assigns chunks, the step depends on the next chunk given to the task:
+   * chunk_step_size: original_step_size * (next_chunk_index - current_chunk_index - 1) * chunk_size
    */
-  for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
-    auto stepOfIV = clonedStepSizeMap.at(ivInfo);
-    auto ivPHI = cast<PHINode>(fetchClone(ivInfo->getLoopEntryPHI()));
+  PHINode *chunkIndexPHI = nullptr;
+  if (!isStaticallyScheduled){
+    chunkIndexPHI = IVUtility::createChunkIndexPHI(preheaderClone, headerClone, chunkPHI, firstChunkIndex, [this](IRBuilder<> &latchBuilder, Value *currentChunkIndex, Value *isChunkCompleted) -> Value * {
+      auto nextChunkIndex = this->createCallToFetchTheNextChunk(latchBuilder, currentChunkIndex, isChunkCompleted);
+
+      /*
+       * Remember the call so it can be executed only at chunk boundaries once the task is complete (see fetchTheNextChunkOnlyAtChunkBoundaries).
+       */
+      auto nextChunkFetch = dyn_cast<CallInst>(nextChunkIndex);
+      if (nextChunkFetch == nullptr){
+        nextChunkFetch = cast<CallInst>(cast<CastInst>(nextChunkIndex)->getOperand(0));
+      }
+      this->nextChunkFetchesInLatches.push_back(std::make_pair(nextChunkFetch, isChunkCompleted));
+
+      return nextChunkIndex;
+    });
+
+    for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
+      auto stepOfIV = clonedStepSizeMap.at(ivInfo);
+      auto ivPHI = cast<PHINode>(fetchClone(ivInfo->getLoopEntryPHI()));
+
+      auto computeChunkStepSize = [task, stepOfIV, chunkIndexPHI, chunkCounterType](BasicBlock *latch, IRBuilder<> &latchBuilder) -> Value * {
+        auto nextChunkIndex = chunkIndexPHI->getIncomingValueForBlock(latch);
+        auto onesValueForChunking = ConstantInt::get(chunkCounterType, 1);
+        auto chunksToSkip = latchBuilder.CreateSub(
+          latchBuilder.CreateSub(nextChunkIndex, chunkIndexPHI),
+          onesValueForChunking,
+          "chunksToSkip"
+        );
+        return latchBuilder.CreateMul(
+          stepOfIV,
+          latchBuilder.CreateSExtOrTrunc(
+            latchBuilder.CreateMul(chunksToSkip, task->chunkSizeArg, "chunksToSkip_X_chunkSize"),
+            stepOfIV->getType()
+          ),
+          "stepSizeToNextChunk"
+        );
+      };
+      IVUtility::chunkInductionVariablePHI(preheaderClone, ivPHI, chunkPHI, computeChunkStepSize);
+    }
 
-    auto onesValueForChunking = ConstantInt::get(chunkCounterType, 1);
-    auto chunkStepSize = entryBuilder.CreateMul(
-      stepOfIV,
-      entryBuilder.CreateZExtOrTrunc(
-        entryBuilder.CreateMul(
-          entryBuilder.CreateSub(task->numCoresArg, onesValueForChunking, "numCoresMinus1"),
-          task->chunkSizeArg,
-          "numCoresMinus1_X_chunkSize"
+  } else {
+    for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
+      auto stepOfIV = clonedStepSizeMap.at(ivInfo);
+      auto ivPHI = cast<PHINode>(fetchClone(ivInfo->getLoopEntryPHI()));
+
+      auto onesValueForChunking = ConstantInt::get(chunkCounterType, 1);
+      auto chunkStepSize = entryBuilder.CreateMul(
+        stepOfIV,
+        entryBuilder.CreateZExtOrTrunc(
+          entryBuilder.CreateMul(
+            entryBuilder.CreateSub(task->numCoresArg, onesValueForChunking, "numCoresMinus1"),
+            task->chunkSizeArg,
+            "numCoresMinus1_X_chunkSize"
+          ),
+          stepOfIV->getType()
         ),
-        stepOfIV->getType()
-      ),
-      "stepSizeToNextChunk"
-    );
+        "stepSizeToNextChunk"
+      );
 
-    IVUtility::chunkInductionVariablePHI(preheaderClone, ivPHI, chunkPHI, chunkStepSize);
+      IVUtility::chunkInductionVariablePHI(preheaderClone, ivPHI, chunkPHI, chunkStepSize);
+    }
   }
 
   /*
@@ -157,7 +219,7 @@ void DOALL::rewireLoopToIterateChunks (
   /*
 	 * Identify any instructions in the header that are NOT sensitive to the number of times they execute:
 	 * 1) IV instructions, including the comparison and branch of the loop governing IV
-	 * 2) The PHI used to chunk iterations 
+	 * 2) The PHIs used to chunk iterations 
 	 * 3) Any PHIs of reducible variables
 	 * 4) Any loop invariant instructions that belong to independent-execution SCCs
    */
@@ -179,6 +241,9 @@ void DOALL::rewireLoopToIterateChunks (
 	 * Collect (2)
 	 */
   repeatableInstructions.insert(chunkPHI);
+  if (chunkIndexPHI != nullptr){
+    repeatableInstructions.insert(chunkIndexPHI);
+  }
 
 	/*
 	 * Collect (3) by identifying all reducible SCCs
@@ -271,3 +336,38 @@ void DOALL::rewireLoopToIterateChunks (
     );
   }
 }
+
+void DOALL::fetchTheNextChunkOnlyAtChunkBoundaries (void){
+
+  /*
+   * The latches of the task ask the runtime for the next chunk at every iteration, and the runtime returns the current chunk until it is completed.
+   * Move each of these calls into a basic block that is executed only when the current chunk is completed:
+   *
+   * latch:       ...  br isChunkCompleted, fetchBB, continueBB
+   * fetchBB:     nextChunkIndex = call NOELLE_DOALL_nextChunk(..., currentChunkIndex, true)  br continueBB
+   * continueBB:  chunkIndex = phi [currentChunkIndex, latch] [nextChunkIndex, fetchBB]  ...
+   *
+   * This splits the latches, so it must follow all other code generated in them.
+   */
+  for (auto &fetchAndCondition : this->nextChunkFetchesInLatches){
+    auto nextChunkFetch = fetchAndCondition.first;
+    auto isChunkCompleted = fetchAndCondition.second;
+    auto latch = nextChunkFetch->getParent();
+
+    auto fetchTerminator = SplitBlockAndInsertIfThen(isChunkCompleted, nextChunkFetch, false);
+    auto fetchBB = fetchTerminator->getParent();
+    auto continueBB = nextChunkFetch->getParent();
+    fetchBB->setName("fetchNextChunk");
+    continueBB->setName(latch->getName() + ".continue");
+    nextChunkFetch->moveBefore(fetchTerminator);
+
+    IRBuilder<> continueBuilder(&*continueBB->begin());
+    auto chunkIndex = continueBuilder.CreatePHI(nextChunkFetch->getType(), 2, "chunkIndexOfNextIteration");
+    nextChunkFetch->replaceAllUsesWith(chunkIndex);
+    chunkIndex->addIncoming(nextChunkFetch->getArgOperand(2), latch);
+    chunkIndex->addIncoming(nextChunkFetch, fetchBB);
+  }
+  this->nextChunkFetchesInLatches.clear();
+
+  return ;
+}
@@ -21,10 +21,11 @@ DOALL::DOALL (
 
   /*
    * Fetch the dispatcher to use to jump to a parallelized DOALL loop.
+   * This dispatcher receives the number of iterations of the invocation as well.
    */
-  this->taskDispatcher = this->module.getFunction("NOELLE_DOALLDispatcher");
+  this->taskDispatcher = this->module.getFunction("NOELLE_DOALLDispatcherWithIterations");
   if (this->taskDispatcher == nullptr){
-    errs() << "NOELLE: ERROR = function NOELLE_DOALLDispatcher couldn't be found\n";
+    errs() << "NOELLE: ERROR = function NOELLE_DOALLDispatcherWithIterations couldn't be found\n";
     abort();
   }
 
@@ -42,6 +43,21 @@ DOALL::DOALL (
   });
   this->taskType = FunctionType::get(Type::getVoidTy(cxt), funcArgTypes, false);
 
+  /*
+   * Fetch the runtime support for the schedules that assign chunks to cores at runtime.
+   * Tasks that rely on them receive the schedule as an additional argument.
+   */
+  this->taskDispatcherWithSchedule = this->module.getFunction("NOELLE_DOALLDispatcherWithSchedule");
+  this->nextChunkFetcher = this->module.getFunction("NOELLE_DOALL_nextChunk");
+  auto funcArgTypesWithSchedule = ArrayRef<Type*>({
+    PointerType::getUnqual(int8),
+    int64,
+    int64,
+    int64,
+    PointerType::getUnqual(int8)
+  });
+  this->taskTypeWithSchedule = FunctionType::get(Type::getVoidTy(cxt), funcArgTypesWithSchedule, false);
+
   return ;
 }
 
@@ -210,12 +226,31 @@ bool DOALL::apply (
     errs() << "DOALL: Start the parallelization\n";
     errs() << "DOALL:   Number of threads to extract = " << LDI->getMaximumNumberOfCores() << "\n";
     errs() << "DOALL:   Chunk size = " << LDI->DOALLChunkSize << "\n";
+    errs() << "DOALL:   Chunk schedule = " << LDI->DOALLChunkSchedule << "\n";
+  }
+
+  /*
+   * Check if the runtime has to assign chunks to cores.
+   *
+   * The schedule is kept in a local variable because the loop (and therefore its schedule) can be shared with other clients of NOELLE.
+   */
+  auto schedule = LDI->DOALLChunkSchedule;
+  if (  (schedule != DOALL_STATIC_SCHEDULE)
+        && (  (this->taskDispatcherWithSchedule == nullptr)
+              || (this->nextChunkFetcher == nullptr)  )
+     ){
+    errs() << "DOALL: WARNING = the runtime does not support the requested schedule. The static one will be used\n";
+    schedule = DOALL_STATIC_SCHEDULE;
+  }
+  auto taskSignature = this->taskType;
+  if (schedule != DOALL_STATIC_SCHEDULE){
+    taskSignature = this->taskTypeWithSchedule;
   }
 
   /*
    * Generate an empty task for the parallel DOALL execution.
    */
-  auto chunkerTask = new DOALLTask(this->taskType, this->module);
+  auto chunkerTask = new DOALLTask(taskSignature, this->module);
   this->generateEmptyTasks(LDI, { chunkerTask });
   this->numTaskInstances = LDI->getMaximumNumberOfCores();
 
@@ -267,7 +302,7 @@ bool DOALL::apply (
   }
 
   this->setReducableVariablesToBeginAtIdentityValue(LDI, 0);
-  this->rewireLoopToIterateChunks(LDI);
+  this->rewireLoopToIterateChunks(LDI, schedule);
   if (this->verbose >= Verbosity::Maximal) {
     errs() << "DOALL:  Rewired induction variables and reducible variables\n";
   }
@@ -289,7 +324,13 @@ bool DOALL::apply (
     errs() << "DOALL:  Stored live outs\n";
   }
 
-  this->addChunkFunctionExecutionAsideOriginalLoop(LDI, loopFunction, par);
+  /*
+   * Ask the runtime for the next chunk only when the current one is completed.
+   * Note this occurs after all other code is generated in the task as it splits the latches.
+   */
+  this->fetchTheNextChunkOnlyAtChunkBoundaries();
+
+  this->addChunkFunctionExecutionAsideOriginalLoop(LDI, loopFunction, par, schedule);
 
   /*
    * Final printing.
@@ -314,7 +355,8 @@ bool DOALL::apply (
 void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
   LoopDependenceInfo *LDI,
   Function *loopFunction,
-  Noelle &par
+  Noelle &par,
+  DOALLSchedule schedule
 ) {
 
   /*
@@ -342,12 +384,38 @@ void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
    * Call the function that incudes the parallelized loop.
    */
   IRBuilder<> doallBuilder(this->entryPointOfParallelizedLoop);
-  auto doallCallInst = doallBuilder.CreateCall(this->taskDispatcher, ArrayRef<Value *>({
-    tasks[0]->getTaskBody(),
-    envPtr,
-    numCores,
-    chunkSize
-  }));
+  this->createCallToSetTheLoopIDInTheRuntime(LDI, doallBuilder);
+
+  /*
+   * Compute the number of iterations of the current invocation of the loop.
+   * The runtime uses it to choose how many cores to use (and by the guided schedule); 0 means it is unknown.
+   */
+  auto numberOfIterations = this->computeTheNumberOfIterations(LDI, doallBuilder, par);
+  CallInst *doallCallInst = nullptr;
+  if (schedule == DOALL_STATIC_SCHEDULE){
+    doallCallInst = doallBuilder.CreateCall(this->taskDispatcher, ArrayRef<Value *>({
+      tasks[0]->getTaskBody(),
+      envPtr,
+      numCores,
+      chunkSize,
+      numberOfIterations
+    }));
+
+  } else {
+
+    /*
+     * The runtime assigns chunks to cores.
+     */
+    auto scheduleValue = ConstantInt::get(par.int64, schedule);
+    doallCallInst = doallBuilder.CreateCall(this->taskDispatcherWithSchedule, ArrayRef<Value *>({
+      tasks[0]->getTaskBody(),
+      envPtr,
+      numCores,
+      chunkSize,
+      scheduleValue,
+      numberOfIterations
+    }));
+  }
   auto numThreadsUsed = doallBuilder.CreateExtractValue(doallCallInst, (uint64_t)0);
 
   /*
@@ -364,6 +432,93 @@ void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
   return ;
 }
 
+Value * DOALL::computeTheNumberOfIterations (
+  LoopDependenceInfo *LDI,
+  IRBuilder<> &builder,
+  Noelle &par
+) const {
+  auto unknown = ConstantInt::get(par.int64, 0);
+
+  /*
+   * Check if the number of iterations is known at compile time.
+   */
+  if (LDI->doesHaveCompileTimeKnownTripCount()){
+    return ConstantInt::get(par.int64, LDI->getCompileTimeTripCount());
+  }
+
+  /*
+   * Fetch the start value, the exit value, and the step of the loop governing induction variable.
+   */
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  if (loopGoverningIVAttr == nullptr){
+    return unknown;
+  }
+  auto &IV = loopGoverningIVAttr->getInductionVariable();
+  auto startValue = IV.getStartValue();
+  auto exitValue = loopGoverningIVAttr->getHeaderCmpInstConditionValue();
+  auto stepValue = dyn_cast_or_null<ConstantInt>(IV.getSingleComputedStepValue());
+  if (  false
+        || (stepValue == nullptr)
+        || (stepValue->isZero())
+        || (!startValue->getType()->isIntegerTy())
+        || (!exitValue->getType()->isIntegerTy())
+     ){
+    return unknown;
+  }
+
+  /*
+   * The exit value must be available before the loop starts.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  if (auto exitInst = dyn_cast<Instruction>(exitValue)){
+    if (loopStructure->isIncluded(exitInst)){
+      return unknown;
+    }
+  }
+
+  /*
+   * Estimate the number of iterations as (exit - start) / step.
+   * The estimate is at least 1 as the header of the loop is always executed.
+   */
+  auto isSigned = loopGoverningIVAttr->getHeaderCmpInst()->isSigned();
+  auto start = builder.CreateIntCast(startValue, par.int64, isSigned);
+  auto exit = builder.CreateIntCast(exitValue, par.int64, isSigned);
+  auto distance = builder.CreateSub(exit, start);
+  auto iterations = builder.CreateSDiv(distance, ConstantInt::get(par.int64, stepValue->getSExtValue()));
+  auto doesIterate = builder.CreateICmpSGT(iterations, ConstantInt::get(par.int64, 0));
+
+  return builder.CreateSelect(doesIterate, iterations, ConstantInt::get(par.int64, 1));
+}
+
+Value * DOALL::createCallToFetchTheNextChunk (
+  IRBuilder<> &builder,
+  Value *currentChunkIndex,
+  Value *isChunkCompleted
+) const {
+  auto task = (DOALLTask *)this->tasks[0];
+  assert(task->scheduleArg != nullptr);
+
+  /*
+   * Adapt the arguments to the signature of the runtime function.
+   */
+  auto runtimeSignature = this->nextChunkFetcher->getFunctionType();
+  auto coreID = builder.CreateZExtOrTrunc(task->coreArg, runtimeSignature->getParamType(1));
+  auto chunkIndex = builder.CreateSExtOrTrunc(currentChunkIndex, runtimeSignature->getParamType(2));
+  auto completed = builder.CreateZExtOrTrunc(isChunkCompleted, runtimeSignature->getParamType(3));
+
+  /*
+   * Ask the runtime for the next chunk.
+   */
+  auto nextChunkIndex = builder.CreateCall(this->nextChunkFetcher, ArrayRef<Value *>({
+    task->scheduleArg,
+    coreID,
+    chunkIndex,
+    completed
+  }), "nextChunkIndex");
+
+  return builder.CreateSExtOrTrunc(nextChunkIndex, currentChunkIndex->getType());
+}
+
 Value * DOALL::fetchClone (Value *original) const {
   auto task = (DOALLTask *)this->tasks[0];
   if (isa<ConstantData>(original)) return original;
@@ -15,6 +15,7 @@ DOALLTask::DOALLTask (
   Module &M
   )
   :Task{0, taskSignature, M}
+  , scheduleArg{nullptr}
   {
 
   return ;
@@ -26,6 +27,9 @@ void DOALLTask::extractFuncArgs (void) {
   this->coreArg = (Value *) &*(argIter++); 
   this->numCoresArg = (Value *) &*(argIter++);
   this->chunkSizeArg = (Value *) &*(argIter++);
+  if (argIter != this->F->arg_end()){
+    this->scheduleArg = (Value *) &*(argIter++);
+  }
   this->instanceIndexV = coreArg;
 
   return ;
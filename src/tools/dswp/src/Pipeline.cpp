@@ -150,6 +150,7 @@ void DSWP::createPipelineFromStages (LoopDependenceInfo *LDI, Noelle &par) {
   /*
    * Add the call to the task dispatcher
    */
+  this->createCallToSetTheLoopIDInTheRuntime(LDI, builder);
   auto runtimeCall = builder.CreateCall(taskDispatcher, ArrayRef<Value*>({
     envPtr,
     queueSizesPtr,
@@ -38,6 +38,47 @@ namespace llvm::noelle {
     */
     auto& noelle = getAnalysis<Noelle>();
 
+    /*
+    * Improve the loops.
+    *
+    * Each invocation changes at most one loop per function.
+    * If we have been asked to reach a fixed point, we normalize the functions that have been modified and we try again until no enabler changes the code.
+    * Enablers only look at the function of the loop they try to improve.
+    * So after the first round, only the functions modified by the previous round can be improved further.
+    */
+    auto modified = false;
+    auto round = 0;
+    std::unordered_set<Function *> functionsToImprove;
+    while (true){
+      std::unordered_set<Function *> modifiedFunctions;
+      auto modifiedInThisRound = this->improveLoops(noelle, (round == 0) ? nullptr : &functionsToImprove, modifiedFunctions);
+      modified |= modifiedInThisRound;
+      if (  false
+            || !modifiedInThisRound
+            || !this->runUntilFixpoint
+        ){
+        break ;
+      }
+
+      /*
+      * Normalize the modified functions as noelle-norm would do.
+      */
+      errs() << "EnablersManager:  Round " << round << " modified " << modifiedFunctions.size() << " functions; normalize them and try again\n";
+      noelle.normalizeFunctions(modifiedFunctions);
+      functionsToImprove = std::move(modifiedFunctions);
+      round++;
+    }
+
+    errs() << "EnablersManager: Exit\n";
+    return modified;
+  }
+
+  bool EnablersManager::improveLoops (
+      Noelle &noelle,
+      std::unordered_set<Function *> const *functionsToImprove,
+      std::unordered_set<Function *> &modifiedFunctions
+    ){
+
     /*
     * Create the enablers.
     */
@@ -57,7 +98,6 @@ namespace llvm::noelle {
     * Parallelize the loops selected.
     */
     auto modified = false;
-    std::unordered_map<Function *, bool> modifiedFunctions;
     for (auto loopStructure : *loopsToParallelize){
 
       /*
@@ -65,10 +105,20 @@ namespace llvm::noelle {
       */
       auto f = loopStructure->getFunction();
 
+      /*
+      * Check if the function can be improved.
+      */
+      if (  true
+            && (functionsToImprove != nullptr)
+            && (functionsToImprove->find(f) == functionsToImprove->end())
+        ){
+        continue ;
+      }
+
       /*
       * Check if we have already modified the function.
       */
-      if (modifiedFunctions[f]){
+      if (modifiedFunctions.find(f) != modifiedFunctions.end()){
         errs() << "EnablersManager:   The current loop belongs to the function " << f->getName() << " , which has already been modified.\n" ;
         continue ;
       }
@@ -81,7 +131,7 @@ namespace llvm::noelle {
       /*
       * Improve the current loop.
       */
-      modifiedFunctions[f] |= this->applyEnablers(
+      auto modifiedLoop = this->applyEnablers(
         loop,
         noelle,
         loopDist,
@@ -90,7 +140,16 @@ namespace llvm::noelle {
         loopInvariantCodeMotion,
         scevSimplification
       );
-      modified |= modifiedFunctions[f];
+      if (!modifiedLoop){
+        continue ;
+      }
+      modifiedFunctions.insert(f);
+      modified = true;
+
+      /*
+      * Only the dependences of the modified function need to be recomputed.
+      */
+      noelle.invalidateFunctionDependences(f);
     }
 
     /*
@@ -98,7 +157,6 @@ namespace llvm::noelle {
     */
     delete loopsToParallelize;
 
-    errs() << "EnablersManager: Exit\n";
     return modified;
   }
 }
\ No newline at end of file
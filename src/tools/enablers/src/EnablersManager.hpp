@@ -48,10 +48,17 @@ namespace llvm::noelle {
        * Fields
        */
       bool enableEnablers;
+      bool runUntilFixpoint;
 
       /*
        * Methods
        */
+      bool improveLoops (
+          Noelle &noelle,
+          std::unordered_set<Function *> const *functionsToImprove,
+          std::unordered_set<Function *> &modifiedFunctions
+        );
+
       std::vector<LoopDependenceInfo *> getLoopsToParallelize (
           Module &M, 
           Noelle &par
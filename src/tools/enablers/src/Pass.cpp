@@ -17,10 +17,12 @@
 using namespace llvm;
 
 static cl::opt<bool> DisableEnablers("noelle-disable-enablers", cl::ZeroOrMore, cl::Hidden, cl::desc("Disable all enablers"));
+static cl::opt<bool> EnablersFixpoint("noelle-enablers-fixpoint", cl::ZeroOrMore, cl::Hidden, cl::desc("Apply the enablers and normalize the modified functions until no enabler changes the code"));
 
 namespace llvm::noelle {
   bool EnablersManager::doInitialization (Module &M) {
     this->enableEnablers = (DisableEnablers.getNumOccurrences() == 0) ? true : false;
+    this->runUntilFixpoint = (EnablersFixpoint.getNumOccurrences() > 0) ? true : false;
 
     return false; 
   }
@@ -57,6 +57,7 @@ void HELIX::addChunkFunctionExecutionAsideOriginalLoop (
    * Call the function that incudes the parallelized loop.
    */
   IRBuilder<> helixBuilder(this->entryPointOfParallelizedLoop);
+  this->createCallToSetTheLoopIDInTheRuntime(LDI, helixBuilder);
   auto runtimeCall = helixBuilder.CreateCall(this->taskDispatcher, ArrayRef<Value *>({
     (Value *)tasks[0]->getTaskBody(),
     envPtr,
@@ -134,13 +134,12 @@ void SequentialSegment::determineEntryAndExitFrontier (
    * Instructions from which no other instruction in the SS can be reached are after the exit frontier
    */
   auto checkIfAfterExitFrontier = [&](Instruction *inst) -> bool {
-    auto &afterInstructions = dfr->OUT(inst);
-    for (auto afterV : afterInstructions) {
+    auto reachesSSInstruction = dfr->iterateOverOUT(inst, [&](Value *afterV) -> bool {
       auto afterI = cast<Instruction>(afterV);
-      if (inst == afterI) continue;
-      if (ssInstructions.find(afterI) != ssInstructions.end()) return false;
-    }
-    return true;
+      if (inst == afterI) return false;
+      return ssInstructions.find(afterI) != ssInstructions.end();
+    });
+    return !reachesSSInstruction;
   };
 
   /*
@@ -350,14 +349,14 @@ std::unordered_map<Instruction *, std::unordered_set<Instruction *>> SequentialS
 
   for (auto B : loopStructure->getBasicBlocks()) {
     for (auto &I : *B) {
-      auto &afterInstructions = dfr->OUT(&I);
-      for (auto afterV : afterInstructions) {
+      dfr->iterateOverOUT(&I, [&](Value *afterV) -> bool {
         auto afterI = cast<Instruction>(afterV);
-        if (&I == afterI) continue;
-        if (!loopStructure->isIncluded(afterI)) continue;
+        if (&I == afterI) return false;
+        if (!loopStructure->isIncluded(afterI)) return false;
 
         beforeInstructionMap.at(afterI).insert(&I);
-      }
+        return false;
+      });
     }
   }
 
@@ -375,41 +374,28 @@ DataFlowResult *HELIX::computeReachabilityFromInstructions (LoopDependenceInfo *
    */
   auto dfa = DataFlowEngine{};
   auto computeGEN = [](Instruction *i, DataFlowResult *df) {
-    auto& gen = df->GEN(i);
-    gen.insert(i);
+    auto& gen = df->denseGEN(i);
+    gen.set(df->getUniverseIndex(i));
     return ;
   };
   auto computeKILL = [](Instruction *, DataFlowResult *) {
     return ;
   };
-  auto computeOUT = [LDI, loopHeader](std::set<Value *>& OUT, Instruction *succ, DataFlowResult *df) {
+  auto propagateFrom = [loopHeader](Instruction *succ) -> bool {
 
     /*
      * Check if the successor is the header.
      * In this case, we do not propagate the reachable instructions.
      * We do this because we are interested in understanding the reachability of instructions within a single iteration.
      */
-    auto succBB = succ->getParent();
     if (succ == &*loopHeader->begin()) {
-      return ;
+      return false;
     }
 
-    /*
-     * Propagate the data flow values.
-     */
-    auto& inS = df->IN(succ);
-    OUT.insert(inS.begin(), inS.end());
-    return ;
+    return true;
   } ;
-  auto computeIN = [](std::set<Value *>& IN, Instruction *inst, DataFlowResult *df) {
-    auto& genI = df->GEN(inst);
-    auto& outI = df->OUT(inst);
-    IN.insert(outI.begin(), outI.end());
-    IN.insert(genI.begin(), genI.end());
-    return ;
-  };
 
-  return dfa.applyBackward(loopFunction, computeGEN, computeKILL, computeIN, computeOUT);
+  return dfa.applyDenseBackward(loopFunction, computeGEN, computeKILL, propagateFrom);
 }
 
 iterator_range<std::unordered_set<SCC *>::iterator> SequentialSegment::getSCCs(void) {
@@ -305,11 +305,12 @@ void HELIX::defineFrontierForLoadsToSpilledLCD (
       invalidatedBlocks.insert(successorToStoreBlock);
       auto terminator = successorToStoreBlock->getTerminator();
 
-      for (auto reachableI : reachabilityDFR->OUT(terminator)) {
-        if (!isa<Instruction>(reachableI)) continue;
+      reachabilityDFR->iterateOverOUT(terminator, [&invalidatedBlocks](Value *reachableI) -> bool {
+        if (!isa<Instruction>(reachableI)) return false;
         auto reachableBlock = cast<Instruction>(reachableI)->getParent();
         invalidatedBlocks.insert(reachableBlock);
-      }
+        return false;
+      });
     }
   }
 
@@ -10,10 +10,15 @@
  */
 #include "HELIX.hpp"
 #include "HELIXTask.hpp"
-#include "Architecture.hpp"
 
 using namespace llvm ;
 
+/*
+ * Size of an entry of the sequential segment arrays allocated by HELIX_dispatcher (see HELIX_sequentialSegment_t in the runtime).
+ * This must match the runtime rather than the cache line of the machine we compile on.
+ */
+#define HELIX_SEQUENTIAL_SEGMENT_BYTES 64
+
 void HELIX::addSynchronizations (
   LoopDependenceInfo *LDI,
   std::vector<SequentialSegment *> *sss
@@ -81,7 +86,7 @@ void HELIX::addSynchronizations (
     /*
      * Compute the offset of the sequential segment entry.
      */
-    auto ssOffset = ssID * Architecture::getCacheLineBytes();
+    auto ssOffset = ssID * HELIX_SEQUENTIAL_SEGMENT_BYTES;
 
     /*
      * Fetch the pointer to the sequential segment entry.
@@ -91,11 +96,18 @@ void HELIX::addSynchronizations (
     return entryBuilder.CreateIntToPtr(ssEntryAsInt, ssArray->getType());
   };
 
+  /*
+   * To enter a sequential segment for the n-th time, a core waits for the previous core to enter it n times.
+   * The first core waits for the last core to enter it n - 1 times instead.
+   */
+  auto isFirstCore = entryBuilder.CreateICmpEQ(helixTask->coreArg, ConstantInt::get(helixTask->coreArg->getType(), 0));
+  auto waitOffset = entryBuilder.CreateSelect(isFirstCore, ConstantInt::get(int64, 0), ConstantInt::get(int64, 1));
+
   /*
    * Fetch sequential segments entry in the past and future array
    * Allocate space to track sequential segment entry state
    */
-  std::vector<Value *> ssPastPtrs{}, ssFuturePtrs{}, ssStates{};
+  std::vector<Value *> ssPastPtrs{}, ssFuturePtrs{}, ssStates{}, ssIterations{};
   for (auto ss : *sss) {
     ssPastPtrs.push_back(fetchEntry(helixTask->ssPastArrayArg, ss->getID()));
     ssFuturePtrs.push_back(fetchEntry(helixTask->ssFutureArrayArg, ss->getID()));
@@ -110,6 +122,15 @@ void HELIX::addSynchronizations (
     auto ssStateAlloca = entryBuilder.CreateAlloca(int64);
     ssStateAlloca->moveBefore(helixTask->getEntry()->getFirstNonPHIOrDbgOrLifetime());
     ssStates.push_back(ssStateAlloca);
+
+    /*
+     * Create a new variable that counts how many times the current thread entered the sequential segment.
+     * This is what HELIX_wait and HELIX_signal synchronize on.
+     */
+    auto ssIterationsAlloca = entryBuilder.CreateAlloca(int64);
+    ssIterationsAlloca->moveBefore(helixTask->getEntry()->getFirstNonPHIOrDbgOrLifetime());
+    entryBuilder.CreateStore(ConstantInt::get(int64, 0), ssIterationsAlloca);
+    ssIterations.push_back(ssIterationsAlloca);
   }
 
   /*
@@ -146,13 +167,18 @@ void HELIX::addSynchronizations (
      * Inject a call to HELIX_wait just before "justAfterEntry"
      * Set the ssState just after the call to HELIX_wait.
      * This will keep track of the fact that we have executed wait for ss in the current iteration.
+     * Also, count the new entrance to ss.
      */
     auto ssWaitBBName = "SS" + std::to_string(ss->getID()) + "-wait";
     auto ssWaitBB = BasicBlock::Create(cxt, ssWaitBBName, helixTask->getTaskBody());
     IRBuilder<> ssWaitBuilder(ssWaitBB);
-    auto wait = ssWaitBuilder.CreateCall(this->waitSSCall, { ssPastPtrs.at(ss->getID()) });
+    auto ssIterationsPtr = ssIterations.at(ss->getID());
+    auto ssIterationsValue = ssWaitBuilder.CreateLoad(ssIterationsPtr);
+    auto iterationToWait = ssWaitBuilder.CreateAdd(ssIterationsValue, waitOffset);
+    auto wait = ssWaitBuilder.CreateCall(this->waitSSCall, { ssPastPtrs.at(ss->getID()), iterationToWait });
     auto ssState = ssStates.at(ss->getID());
     ssWaitBuilder.CreateStore(ConstantInt::get(int64, 1), ssState);
+    ssWaitBuilder.CreateStore(ssWaitBuilder.CreateAdd(ssIterationsValue, ConstantInt::get(int64, 1)), ssIterationsPtr);
     ssWaitBuilder.CreateBr(ssEntryBB);
 
     /*
@@ -178,23 +204,27 @@ void HELIX::addSynchronizations (
 
     /*
      * Inject a call to HELIX_signal just after "justBeforeExit" 
+     * The signal publishes how many times the current thread entered ss.
      * NOTE: If the exit is not an unconditional branch, inject the signal in every successor block
      */
+    auto createSignal = [&](IRBuilder<> &beforeExitBuilder) -> void {
+      auto ssIterationsValue = beforeExitBuilder.CreateLoad(ssIterations.at(ss->getID()));
+      auto signal = beforeExitBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()), ssIterationsValue });
+      helixTask->signals.insert(cast<CallInst>(signal));
+    };
     auto block = justBeforeExit->getParent();
     auto terminator = block->getTerminator();
     auto justBeforeExitBr = dyn_cast<BranchInst>(justBeforeExit);
     if (!justBeforeExitBr || justBeforeExitBr->isUnconditional()) {
       Instruction *insertPoint = terminator == justBeforeExit ? terminator : justBeforeExit->getNextNode();
       IRBuilder<> beforeExitBuilder(insertPoint);
-      auto signal = beforeExitBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()) });
-      helixTask->signals.insert(cast<CallInst>(signal));
+      createSignal(beforeExitBuilder);
       return;
     }
 
     for (auto successorBlock : successors(block)) {
       IRBuilder<> beforeExitBuilder(successorBlock->getFirstNonPHIOrDbgOrLifetime());
-      auto signal = beforeExitBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()) });
-      helixTask->signals.insert(cast<CallInst>(signal));
+      createSignal(beforeExitBuilder);
     }
   };
 
@@ -45,8 +45,10 @@ namespace llvm::noelle {
        * Inlining procedure
        */
       void getLoopsToInline (Noelle &noelle, Hot *profiles) ;
+      void getLoopsToInline (Noelle &noelle, Hot *profiles, Function *F) ;
+      void recollectLoopsToInline (Noelle &noelle, Hot *profiles, Function *F) ;
       bool registerRemainingLoops (std::string filename) ;
-      bool inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, noelle::CallGraph *pcg) ;
+      bool inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, noelle::CallGraph *pcg, std::set<Function *> &fnsToRevisit) ;
       bool inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop (Function *F, LoopDependenceInfo *LDI, noelle::CallGraph *pcg) ;
 
       void getFunctionsToInline (std::string filename) ;
@@ -60,7 +62,7 @@ namespace llvm::noelle {
       bool inlineFunctionCall (Function *F, Function *childF, CallInst *call) ;
       int getNextPreorderLoopAfter (Function *F, CallInst *call) ;
       void adjustLoopOrdersAfterInline (Function *F, Function *childF, int nextLoop) ;
-      void adjustFnGraphAfterInline (Function *F, Function *childF, int callInd) ;
+      void adjustFnGraphAfterInline (Function *F) ;
 
       /*
        * Function and loop order tracking
@@ -100,8 +100,30 @@ bool Inliner::runOnModule (Module &M) {
 
   /*
   * Perform the inlining.
+  *
+  * Each round inlines at most one call per function as the dependences of a function are stale after inlining within it.
+  * Between rounds, we normalize the functions modified as noelle-norm would do and we recompute only their loops and dependences.
+  * The other functions cannot expose new calls to inline unless they have been skipped in the last round.
+  *
+  * Notice that the program call graph does not need to be updated: we never inline callees that belong to a cycle of the call graph and inlining any other callee preserves the cycles of the call graph.
   */
-  auto inlined = this->inlineCallsInvolvedInLoopCarriedDataDependences(noelle, pcg);
+  std::set<Function *> fnsToRevisit;
+  for (auto fnLoops : loopsToCheck) {
+    fnsToRevisit.insert(fnLoops.first);
+  }
+  auto inlined = false;
+  while (this->inlineCallsInvolvedInLoopCarriedDataDependences(noelle, pcg, fnsToRevisit)){
+    inlined = true;
+
+    if (this->verbose != Verbosity::Disabled){
+      errs() << "Inliner:   Inlined calls in " << fnsAffected.size() << " functions; normalize them and try again\n";
+    }
+    noelle.normalizeFunctions(std::unordered_set<Function *>(fnsAffected.begin(), fnsAffected.end()));
+    for (auto F : fnsAffected) {
+      recollectLoopsToInline(noelle, profiles, F);
+    }
+    fnsAffected.clear();
+  }
   if (inlined){
     writeToContinueFile();
 
@@ -144,15 +166,16 @@ bool Inliner::runOnModule (Module &M) {
     std::string filename = "dgsimplify_loop_hoisting.txt";
     getFunctionsToInline(filename);
 
-    bool inlined = inlineFnsOfLoopsToCGRoot();
+    /*
+    * The function graph is updated after every inlining.
+    * Hence, we keep hoisting until no function can be inlined in its parents, one call per parent at a time.
+    */
+    bool inlined = false;
+    while (inlineFnsOfLoopsToCGRoot()) {
+      inlined = true;
+      fnsAffected.clear();
+    }
     if (inlined) {
-      getAnalysis<CallGraphWrapperPass>().runOnModule(M);
-      parentFns.clear();
-      childrenFns.clear();
-      orderedCalled.clear();
-      orderedCalls.clear();
-      collectFnGraph(main);
-      collectInDepthOrderFns(main);
       printFnOrder();
     }
 
@@ -184,34 +207,58 @@ bool Inliner::runOnModule (Module &M) {
 * Progress Tracking using file system
 */
 void Inliner::getLoopsToInline (Noelle &noelle, Hot *profiles) {
+  for (auto funcLoops : preOrderedLoops) {
+    getLoopsToInline(noelle, profiles, funcLoops.first);
+  }
+}
+
+void Inliner::getLoopsToInline (Noelle &noelle, Hot *profiles, Function *F) {
   assert(profiles != nullptr);
 
-  for (auto funcLoops : preOrderedLoops) {
-    auto F = funcLoops.first;
-    for (auto summary : *funcLoops.second) {
+  if (preOrderedLoops.find(F) == preOrderedLoops.end()) return;
+  for (auto summary : *preOrderedLoops[F]) {
 
-      /*
-      * Check if the profile is available.
+    /*
+    * Check if the profile is available.
+    */
+    if (profiles->isAvailable()){
+      
+      /* 
+      * Check if the loop is hot enough.
       */
-      if (profiles->isAvailable()){
-        
-        /* 
-        * Check if the loop is hot enough.
-        */
-        auto hotness = profiles->getDynamicTotalInstructionCoverage(summary);
-        if (hotness < noelle.getMinimumHotness()){
+      auto hotness = profiles->getDynamicTotalInstructionCoverage(summary);
+      if (hotness < noelle.getMinimumHotness()){
 
-          /*
-          * The loop isn't hot enough.
-          */
-          continue ;
-        }
+        /*
+        * The loop isn't hot enough.
+        */
+        continue ;
       }
-      loopsToCheck[F].push_back(summary);
     }
+    loopsToCheck[F].push_back(summary);
   }
 }
 
+void Inliner::recollectLoopsToInline (Noelle &noelle, Hot *profiles, Function *F) {
+
+  /*
+  * The loops of @F have changed.
+  * Forget their summaries (they are still owned by loopSummaries) and compute them again.
+  */
+  if (preOrderedLoops.find(F) != preOrderedLoops.end()) {
+    delete preOrderedLoops[F];
+    preOrderedLoops.erase(F);
+  }
+  loopsToCheck.erase(F);
+  createPreOrderedLoopSummariesFor(F);
+  getLoopsToInline(noelle, profiles, F);
+
+  /*
+  * Normalization can delete calls.
+  */
+  adjustFnGraphAfterInline(F);
+}
+
 void Inliner::getFunctionsToInline (std::string filename) {
   fnsToCheck.clear();
   ifstream infile(filename);
@@ -310,19 +357,20 @@ bool Inliner::inlineFnsOfLoopsToCGRoot () {
       }
 
       // NOTE(angelo): Insert parent to affect (in depth order, if not already present)
+      //  The parent is shallower than the child, so it is checked later within this same invocation
       if (fnsWillCheck.find(parentF) != fnsWillCheck.end()) continue;
       fnsWillCheck.insert(parentF);
-      auto insertIndex = 0;
       assert(fnOrders.find(parentF) != fnOrders.end());
       auto parentFnOrder = fnOrders[parentF];
-      for (auto insertIndex = 0; insertIndex < orderedFns.size() ; insertIndex++){
+      auto insertIndex = fnIndex;
+      while (insertIndex < orderedFns.size()) {
         auto currentFunction = orderedFns[insertIndex];
         auto currentFunctionFnOrder = fnOrders[currentFunction];
-        if (currentFunctionFnOrder > parentFnOrder){
+        if (currentFunctionFnOrder < parentFnOrder){
           break ;
         }
+        insertIndex++;
       }
-      assert(insertIndex < orderedFns.size());
       orderedFns.insert(orderedFns.begin() + insertIndex, parentF);
     }
 
@@ -353,14 +401,17 @@ bool Inliner::inlineFunctionCall (Function *F, Function *childF, CallInst *call)
   }
 
   int loopIndAfterCall = getNextPreorderLoopAfter(F, call);
-  auto &parentCalls = orderedCalls[F];
-  auto callInd = std::find(parentCalls.begin(), parentCalls.end(), call) - parentCalls.begin();
 
-  InlineFunctionInfo IFI;
+  // NOTE: Let the inliner update the call graph so the function graph can be adjusted without recomputing it
+  auto &callGraph = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  InlineFunctionInfo IFI(&callGraph);
   if (InlineFunction(call, IFI)) {
     fnsAffected.insert(F);
     adjustLoopOrdersAfterInline(F, childF, loopIndAfterCall);
-    adjustFnGraphAfterInline(F, childF, callInd);
+    adjustFnGraphAfterInline(F);
+
+    auto &noelle = getAnalysis<Noelle>();
+    noelle.invalidateFunctionDependences(F);
     return true;
   }
   return false;
@@ -417,36 +468,22 @@ void Inliner::adjustLoopOrdersAfterInline (Function *parentF, Function *childF,
   }
 }
 
-// NOTE(joe) This function doesn't correctly adjust Function Graph, since the function used to compute
-// childrenFns and parentFns [collectFnGraph] and therefore depthOrdered and fnOrder [in collectInDepthOrderFns] doesn't
-// take into account the defferent function that never got an order. This causes the number to be out between successive
-// iterations of this inliner.
-void Inliner::adjustFnGraphAfterInline (Function *parentF, Function *childF, int callInd) {
-  auto &parentCalled = orderedCalled[parentF];
-  auto &childCalled = orderedCalled[childF];
-
-  parentCalled.erase(parentCalled.begin() + callInd);
-  if (!childCalled.empty()) {
-    auto childCallCount = childCalled.size();
-    auto endInsertAt = callInd + childCallCount;
-
-    // Shift over calls after the inlined call to make room for called function's calls
-    parentCalled.resize(parentCalled.size() + childCallCount);
-    for (auto shiftIndex = parentCalled.size() - 1; shiftIndex >= endInsertAt; --shiftIndex) {
-      parentCalled[shiftIndex] = parentCalled[shiftIndex - childCallCount];
-    }
+// The depth order [depthOrderedFns and fnOrders] is not recomputed after inlining: the calls added to the
+// function inlined within target functions that were already reachable from it. However, the order computed by the next
+// invocation of this inliner [in collectInDepthOrderFns] can differ, since the functions that never got an order are deferred.
+void Inliner::adjustFnGraphAfterInline (Function *parentF) {
 
-    // Insert the called function's calls starting from the position of the inlined call
-    for (auto childIndex = callInd; childIndex < endInsertAt; ++childIndex) {
-      parentCalled[childIndex] = childCalled[childIndex - callInd];
-    }
-  }
+  // Recollect the calls of the function inlined within, including the ones cloned from the inlined function
+  auto &callGraph = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  collectFnCallsAndCalled(callGraph, parentF);
 
   // Readjust function graph of the function inlined within
   std::set<Function *> reached;
+  for (auto F : childrenFns[parentF]) {
+    parentFns[F].erase(parentF);
+  }
   childrenFns[parentF].clear();
-  parentFns[childF].erase(parentF);
-  for (auto F : parentCalled) {
+  for (auto F : orderedCalled[parentF]) {
     if (reached.find(F) != reached.end()) continue;
     reached.insert(F);
     childrenFns[parentF].push_back(F);
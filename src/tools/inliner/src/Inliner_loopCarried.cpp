@@ -11,7 +11,7 @@
 #include "Inliner.hpp"
 #include "DOALL.hpp"
 
-bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, noelle::CallGraph *pcg) {
+bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, noelle::CallGraph *pcg, std::set<Function *> &fnsToRevisit) {
   auto anyInlined = false;
 
   /*
@@ -19,10 +19,18 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, n
    */
   std::vector<Function *> orderedFns;
   for (auto fnLoops : loopsToCheck) {
+    if (fnsToRevisit.find(fnLoops.first) == fnsToRevisit.end()) {
+      continue;
+    }
     orderedFns.push_back(fnLoops.first);
   }
   sortInDepthOrderFns(orderedFns);
 
+  /*
+   * Only the functions that will be skipped or modified need to be checked again.
+   */
+  fnsToRevisit.clear();
+
   std::set<Function *> fnsToAvoid;
   for (auto F : orderedFns) {
     
@@ -33,6 +41,7 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, n
       for (auto parentF : parentFns[F]) {
         fnsToAvoid.insert(parentF);
       }
+      fnsToRevisit.insert(F);
       continue;
     }
 
@@ -127,10 +136,8 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, n
 
     /*
      * Free the memory.
+     * The loop dependence infos are owned by NOELLE.
      */
-    for (auto tempLDI : *allLoops){
-      delete tempLDI;
-    }
     delete allLoops ;
 
     /*
@@ -143,6 +150,7 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences (Noelle &noelle, n
      * This is because we are not finished with the affected functions.
      */
     if (inlined) {
+      fnsToRevisit.insert(F);
       for (auto parentF : parentFns[F]) {
         fnsToAvoid.insert(parentF);
       }
@@ -15,7 +15,7 @@ using namespace llvm;
 void LoopStats::collectStatsOnLLVMSCCs (Hot *profiles, PDG *loopDG, Stats *statsForLoop) {
 
   /*
-   * Construct loop internal SCCDAG (it uses LLVM's scc_iterator)
+   * Construct loop internal SCCDAG
    */
   std::vector<Value *> loopInternals;
   for (auto internalNode : loopDG->internalNodePairs()) {
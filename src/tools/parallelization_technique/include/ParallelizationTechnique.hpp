@@ -203,6 +203,14 @@ namespace llvm::noelle {
        */
       void doNestedInlineOfCalls (Function *F, std::set<CallInst *> &calls);
 
+      /*
+       * Tell the runtime the ID of the loop executed by the next dispatcher invoked (used by the runtime profiler).
+       */
+      void createCallToSetTheLoopIDInTheRuntime (
+        LoopDependenceInfo *LDI,
+        IRBuilder<> &builder
+      );
+
       float computeSequentialFractionOfExecution (
         LoopDependenceInfo *LDI,
         Noelle &par
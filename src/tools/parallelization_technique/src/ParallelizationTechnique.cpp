@@ -942,6 +942,31 @@ void ParallelizationTechnique::generateCodeToStoreExitBlockIndex (
   return ;
 }
 
+void ParallelizationTechnique::createCallToSetTheLoopIDInTheRuntime (
+  LoopDependenceInfo *LDI,
+  IRBuilder<> &builder
+){
+
+  /*
+   * Fetch the runtime API.
+   * Runtimes that do not provide it do not need the ID.
+   */
+  auto setLoopID = this->module.getFunction("NOELLE_setLoopID");
+  if (setLoopID == nullptr){
+    return ;
+  }
+
+  /*
+   * Set the ID.
+   */
+  auto loopIDType = setLoopID->getFunctionType()->getParamType(0);
+  builder.CreateCall(setLoopID, ArrayRef<Value *>({
+    ConstantInt::get(loopIDType, LDI->getID())
+  }));
+
+  return ;
+}
+
 void ParallelizationTechnique::doNestedInlineOfCalls (
   Function *function,
   std::set<CallInst *> &calls
@@ -965,6 +990,11 @@ void ParallelizationTechnique::doNestedInlineOfCalls (
           if (auto call = dyn_cast<CallInst>(&I)) {
             auto func = call->getCalledFunction();
             if (func == nullptr || func->empty()) continue;
+
+            /*
+             * Slow paths of the runtime (e.g., waiting on a queue) are kept out of line.
+             */
+            if (func->hasFnAttribute(Attribute::NoInline)) continue;
             funcToInline.insert(func);
           }
         }
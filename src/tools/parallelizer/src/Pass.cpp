@@ -223,6 +223,7 @@ namespace llvm::noelle {
     */
     auto modified = false;
     std::unordered_map<BasicBlock *, bool> modifiedBBs{};
+    std::unordered_set<Function *> modifiedFunctions{};
     for (auto tree : forest->getTrees()){
 
       /*
@@ -266,15 +267,18 @@ namespace llvm::noelle {
           for (auto bb : ls->getBasicBlocks()){
             modifiedBBs[bb] = true;
           }
+          modifiedFunctions.insert(ls->getFunction());
         }
       }
 
       /*
-      * Free the memory.
+      * The loop dependence infos of the functions we have modified are not valid anymore.
+      * The other ones are kept by NOELLE for later requests.
       */
-      for (auto loop : loopsToParallelize){
-        delete loop;
+      for (auto f : modifiedFunctions){
+        noelle.invalidateLoops(f);
       }
+      modifiedFunctions.clear();
     }
 
     return modified;
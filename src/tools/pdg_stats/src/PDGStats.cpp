@@ -8,6 +8,8 @@
  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <chrono>
+
 #include "SystemHeaders.hpp"
 #include "PDGStats.hpp"
 #include "Noelle.hpp"
@@ -66,6 +68,11 @@ bool PDGStats::runOnModule(Module &M) {
     this->analyzeDependence(edge);
   }
 
+  /*
+   * Measure the memory and the traversal time of the PDG.
+   */
+  this->collectStatsForPDGStorage(PDG);
+
   /*
    * Collect the statistics for all functions.
    */
@@ -75,6 +82,11 @@ bool PDGStats::runOnModule(Module &M) {
     this->collectStatsForLoopEdges(noelle, programLoopForests, lsToLDI, F);
   }
 
+  /*
+   * Measure the construction of the SCCDAGs of the loops.
+   */
+  this->collectStatsForLoopSCCDAGs(programLoopForests, lsToLDI);
+
   /*
    * Print the statistics.
    */
@@ -202,6 +214,89 @@ void PDGStats::collectStatsForLoopEdges (
   return;
 }
 
+void PDGStats::collectStatsForLoopSCCDAGs (
+  std::unordered_map<Function *, StayConnectedNestedLoopForest *> &programLoops, 
+  std::unordered_map<LoopStructure *, LoopDependenceInfo *> &lsToLDI
+  ){
+
+  /*
+   * Check every loop of the program.
+   */
+  for (auto funcLoops : programLoops){
+    auto loopForest = funcLoops.second;
+    for (auto loopTree : loopForest->getTrees()){
+      auto visitor = [this, &lsToLDI](StayConnectedNestedLoopForestNode *n, uint32_t level) -> bool {
+
+        /*
+         * Fetch the loop dependence graph.
+         */
+        auto currentLoop = n->getLoop();
+        auto currentLDI = lsToLDI[currentLoop];
+        assert(currentLDI != nullptr);
+        auto loopDG = currentLDI->getLoopDG();
+
+        /*
+         * Build the SCCDAG of the loop from scratch.
+         */
+        auto start = std::chrono::steady_clock::now();
+        auto loopSCCDAG = new SCCDAG(loopDG);
+        auto end = std::chrono::steady_clock::now();
+
+        this->numberOfSCCDAGs++;
+        this->numberOfSCCDAGNodes += loopSCCDAG->numNodes();
+        this->timeToBuildSCCDAGs += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        delete loopSCCDAG;
+
+        return false;
+      };
+      loopTree->visitPreOrder(visitor);
+    }
+  }
+
+  return;
+}
+
+void PDGStats::collectStatsForPDGStorage (PDG *pdg){
+
+  /*
+   * Measure the memory used by the PDG.
+   */
+  this->memoryUsedByPDG = pdg->getMemoryFootprint();
+
+  /*
+   * Measure the time to visit every node of the PDG following its outgoing edges (depth first).
+   */
+  auto start = std::chrono::steady_clock::now();
+  std::unordered_set<DGNode<Value> *> visited;
+  std::vector<DGNode<Value> *> toVisit;
+  uint64_t memoryEdgesVisited = 0;
+  for (auto node : pdg->getNodes()){
+    if (!visited.insert(node).second){
+      continue ;
+    }
+    toVisit.push_back(node);
+    while (!toVisit.empty()){
+      auto currentNode = toVisit.back();
+      toVisit.pop_back();
+      for (auto edge : currentNode->getOutgoingEdges()){
+        if (edge->isMemoryDependence()){
+          memoryEdgesVisited++;
+        }
+        auto dstNode = edge->getIncomingNode();
+        if (visited.insert(dstNode).second){
+          toVisit.push_back(dstNode);
+        }
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  this->timeToTraversePDG = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  assert(visited.size() == pdg->numNodes());
+  assert(memoryEdgesVisited <= pdg->numEdges());
+
+  return ;
+}
+
 bool PDGStats::edgeIsDependenceOf(MDNode *edgeM, const EDGE_ATTRIBUTE edgeAttribute) {
   if (MDNode *m = dyn_cast<MDNode>(edgeM->getOperand(edgeAttribute))) {
     if (MDString *s = dyn_cast<MDString>(m->getOperand(0))) {
@@ -222,6 +317,11 @@ void PDGStats::printStats() {
   errs() << "     Number of memory must dependences: " << this->numberOfMemoryMustDependence << "\n";
   errs() << "     Number of memory may dependences: " << this->numberOfMemoryDependence - this->numberOfMemoryMustDependence << "\n";
   errs() << "     Number of potential memory dependences: " << this->numberOfPotentialMemoryDependences << "\n";
+  errs() << "Number of loop SCCDAGs: " << this->numberOfSCCDAGs << "\n";
+  errs() << " Number of SCCs: " << this->numberOfSCCDAGNodes << "\n";
+  errs() << " Time to build the SCCDAGs (microseconds): " << this->timeToBuildSCCDAGs << "\n";
+  errs() << "Memory used by the PDG (bytes): " << this->memoryUsedByPDG << "\n";
+  errs() << "Time to traverse the PDG (microseconds): " << this->timeToTraversePDG << "\n";
 
   return;
 }
@@ -40,6 +40,11 @@ namespace llvm {
       int64_t numberOfMemoryMustDependence = 0;
       int64_t numberOfPotentialMemoryDependences = 0;
       int64_t numberOfControlDependence = 0;
+      int64_t numberOfSCCDAGs = 0;
+      int64_t numberOfSCCDAGNodes = 0;
+      int64_t timeToBuildSCCDAGs = 0;
+      int64_t memoryUsedByPDG = 0;
+      int64_t timeToTraversePDG = 0;
 
       void collectStatsForNodes(Function &F);
       void collectStatsForPotentialEdges (std::unordered_map<Function *, StayConnectedNestedLoopForest *> &programLoops, Function &F) ;
@@ -51,6 +56,13 @@ namespace llvm {
         Function &F
         );
 
+      void collectStatsForLoopSCCDAGs (
+        std::unordered_map<Function *, StayConnectedNestedLoopForest *> &programLoops, 
+        std::unordered_map<LoopStructure *, LoopDependenceInfo *> &lsToLDI
+        );
+
+      void collectStatsForPDGStorage (PDG *pdg);
+
       void analyzeDependence (DGEdge<Value> *edge);
 
       bool edgeIsDependenceOf(MDNode *edgeM, EDGE_ATTRIBUTE edgeAttribute);
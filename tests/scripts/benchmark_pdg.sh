@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Measure the memory used by the PDGs of the regression tests and the time to traverse them.
+cd regression ;
+
+totalMemory="0" ;
+totalTime="0" ;
+for i in `ls`; do
+  if ! test -d $i ; then
+    continue ;
+  fi
+  cd $i ;
+
+  # Generate the bitcode with the embedded PDG
+  make baseline_with_metadata.bc &> compiler_output.txt ;
+  if test $? -ne 0 ; then
+    echo "$i: ERROR while compiling (see `pwd`/compiler_output.txt)" ;
+    cd ../ ;
+    continue ;
+  fi
+
+  # Measure the PDG
+  noelle-pdg-stats baseline_with_metadata.bc &> pdg_stats.txt ;
+  nodes=`grep "Number of Nodes:" pdg_stats.txt | awk '{print $NF}'` ;
+  edges=`grep "Number of Edges" pdg_stats.txt | awk '{print $NF}'` ;
+  memoryMeasured=`grep "Memory used by the PDG" pdg_stats.txt | awk '{print $NF}'` ;
+  timeMeasured=`grep "Time to traverse the PDG" pdg_stats.txt | awk '{print $NF}'` ;
+  if test "$memoryMeasured" == "" -o "$timeMeasured" == "" ; then
+    echo "$i: ERROR while measuring the PDG (see `pwd`/pdg_stats.txt)" ;
+    cd ../ ;
+    continue ;
+  fi
+  echo "$i: $nodes nodes, $edges edges, $memoryMeasured bytes, $timeMeasured microseconds" ;
+  totalMemory=`echo "$totalMemory + $memoryMeasured" | bc` ;
+  totalTime=`echo "$totalTime + $timeMeasured" | bc` ;
+
+  cd ../ ;
+done
+
+echo "Total memory used by the PDGs: $totalMemory bytes" ;
+echo "Total time to traverse the PDGs: $totalTime microseconds" ;
+
+cd ../ ;
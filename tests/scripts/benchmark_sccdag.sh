@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Measure the time spent building the SCCDAGs of the loops of the regression tests.
+cd regression ;
+
+totalTime="0" ;
+for i in `ls`; do
+  if ! test -d $i ; then
+    continue ;
+  fi
+  cd $i ;
+
+  # Generate the bitcode with the embedded PDG
+  make baseline_with_metadata.bc &> compiler_output.txt ;
+  if test $? -ne 0 ; then
+    echo "$i: ERROR while compiling (see `pwd`/compiler_output.txt)" ;
+    cd ../ ;
+    continue ;
+  fi
+
+  # Build the SCCDAGs
+  noelle-pdg-stats baseline_with_metadata.bc &> sccdag_stats.txt ;
+  sccdags=`grep "Number of loop SCCDAGs:" sccdag_stats.txt | awk '{print $NF}'` ;
+  sccs=`grep "Number of SCCs:" sccdag_stats.txt | awk '{print $NF}'` ;
+  timeMeasured=`grep "Time to build the SCCDAGs" sccdag_stats.txt | awk '{print $NF}'` ;
+  if test "$timeMeasured" == "" ; then
+    echo "$i: ERROR while building the SCCDAGs (see `pwd`/sccdag_stats.txt)" ;
+    cd ../ ;
+    continue ;
+  fi
+  echo "$i: $sccdags SCCDAGs, $sccs SCCs, $timeMeasured microseconds" ;
+  totalTime=`echo "$totalTime + $timeMeasured" | bc` ;
+
+  cd ../ ;
+done
+
+echo "Total time to build the SCCDAGs: $totalTime microseconds" ;
+
+cd ../ ;